@@ -70,12 +70,6 @@ static void Volume_Mix16(int16_t* samples, int count, int volume) {
 	}
 }
 
-static void Volume_Mix8(uint8_t* samples, int count, int volume) {
-	int i;
-	for (i = 0; i < count; i++, samples++) {
-		samples[0] = (127 + (samples[0] - 127) * volume / 100);
-	}
-}
 
 
 /*########################################################################################################################*
@@ -90,13 +84,17 @@ struct AudioContext {
 	int Count;
 };
 static struct AudioContext Audio_Contexts[20];
-static void Audio_SysInit(void) { }
-static void Audio_SysFree(void) { }
+/* Sounds and music threads may open/close contexts at the same time */
+static void* audio_lock;
+
+static void Audio_SysInit(void) { audio_lock = Mutex_Create(); }
+static void Audio_SysFree(void) { Mutex_Free(audio_lock); }
 
 void Audio_Open(AudioHandle* handle, int buffers) {
 	struct AudioContext* ctx;
 	int i, j;
 
+	Mutex_Lock(audio_lock);
 	for (i = 0; i < Array_Elems(Audio_Contexts); i++) {
 		ctx = &Audio_Contexts[i];
 		if (ctx->Count) continue;
@@ -107,23 +105,31 @@ void Audio_Open(AudioHandle* handle, int buffers) {
 
 		*handle    = i;
 		ctx->Count = buffers;
+		Mutex_Unlock(audio_lock);
 		return;
 	}
+	Mutex_Unlock(audio_lock);
 	Logger_Abort("No free audio contexts");
 }
 
 ReturnCode Audio_Close(AudioHandle handle) {
 	struct AudioFormat fmt = { 0 };
 	struct AudioContext* ctx;
-	ReturnCode res;
+	ReturnCode res = 0;
 	ctx = &Audio_Contexts[handle];
 
-	ctx->Count  = 0;
-	ctx->Format = fmt;
-	if (!ctx->Handle) return 0;
+	if (ctx->Handle) {
+		res = waveOutClose(ctx->Handle);
+		ctx->Handle = NULL;
+	}
 
-	res = waveOutClose(ctx->Handle);
-	ctx->Handle = NULL;
+	/* Only give up the slot once the handle is closed */
+	Mutex_Lock(audio_lock);
+	{
+		ctx->Count  = 0;
+		ctx->Format = fmt;
+	}
+	Mutex_Unlock(audio_lock);
 	return res;
 }
 
@@ -259,30 +265,32 @@ void Audio_Open(AudioHandle* handle, int buffers) {
 	ALenum err;
 	int i, j;
 
+	/* Sounds and music threads may open/close contexts at the same time */
 	Mutex_Lock(&audio_lock);
 	{
 		if (!audio_context) Audio_CreateContext();
 		audio_refs++;
-	}
-	Mutex_Unlock(&audio_lock);
 
-	alDistanceModel(AL_NONE);
-	err = alGetError();
-	if (err) { Logger_Abort2(err, "DistanceModel"); }
+		alDistanceModel(AL_NONE);
+		err = alGetError();
+		if (err) { Logger_Abort2(err, "DistanceModel"); }
 
-	for (i = 0; i < Array_Elems(Audio_Contexts); i++) {
-		struct AudioContext* ctx = &Audio_Contexts[i];
-		if (ctx->Count) continue;
+		for (i = 0; i < Array_Elems(Audio_Contexts); i++) {
+			struct AudioContext* ctx = &Audio_Contexts[i];
+			if (ctx->Count) continue;
 
-		for (j = 0; j < buffers; j++) {
-			ctx->Completed[j] = true;
-		}
+			for (j = 0; j < buffers; j++) {
+				ctx->Completed[j] = true;
+			}
 
-		*handle     = i;
-		ctx->Count  = buffers;
-		ctx->Source = -1;
-		return;
+			*handle     = i;
+			ctx->Count  = buffers;
+			ctx->Source = -1;
+			Mutex_Unlock(&audio_lock);
+			return;
+		}
 	}
+	Mutex_Unlock(&audio_lock);
 	Logger_Abort("No free audio contexts");
 }
 
@@ -293,19 +301,18 @@ ReturnCode Audio_Close(AudioHandle handle) {
 	ctx = &Audio_Contexts[handle];
 
 	if (!ctx->Count) return 0;
-	ctx->Count  = 0;
-	ctx->Format = fmt;
-
 	err = Audio_FreeSource(ctx);
-	if (err) return err;
 
+	/* Only give up the slot once its source is deleted */
 	Mutex_Lock(&audio_lock);
 	{
+		ctx->Count  = 0;
+		ctx->Format = fmt;
 		audio_refs--;
 		if (audio_refs == 0) Audio_DestroyContext();
 	}
 	Mutex_Unlock(&audio_lock);
-	return 0;
+	return err;
 }
 
 static ALenum GetALFormat(int channels, int bitsPerSample) {
@@ -510,6 +517,20 @@ static struct SoundGroup* Soundboard_Find(struct Soundboard* board, const String
 	return NULL;
 }
 
+/* Logs one line per sound group, with the number of clips and total size of their PCM data */
+static void Soundboard_LogSizes(struct Soundboard* board, const String* boardName) {
+	struct SoundGroup* group;
+	int i, j, size;
+
+	for (i = 0; i < board->Count; i++) {
+		group = &board->Groups[i];
+		size  = 0;
+		for (j = 0; j < group->Count; j++) { size += (int)group->Sounds[j].Size; }
+
+		Platform_Log4("loaded %s%s sounds: %i clips, %i bytes", boardName, &group->Name, &group->Count, &size);
+	}
+}
+
 static void Soundboard_Init(struct Soundboard* board, const String* boardName, StringsBuffer* files) {
 	String file, name;
 	struct SoundGroup* group;
@@ -533,7 +554,7 @@ static void Soundboard_Init(struct Soundboard* board, const String* boardName, S
 		group = Soundboard_Find(board, &name);
 		if (!group) {
 			if (board->Count == Array_Elems(board->Groups)) {
-				Chat_AddRaw("&cCannot have more than 10 sound groups"); return;
+				Chat_AddRaw("&cCannot have more than 10 sound groups"); break;
 			}
 
 			group = &board->Groups[board->Count++];
@@ -542,7 +563,7 @@ static void Soundboard_Init(struct Soundboard* board, const String* boardName, S
 		}
 
 		if (group->Count == Array_Elems(group->Sounds)) {
-			Chat_AddRaw("&cCannot have more than 10 sounds in a group"); return;
+			Chat_AddRaw("&cCannot have more than 10 sounds in a group"); break;
 		}
 
 		snd = &group->Sounds[group->Count];
@@ -555,6 +576,7 @@ static void Soundboard_Init(struct Soundboard* board, const String* boardName, S
 			snd->Size = 0;
 		} else { group->Count++; }
 	}
+	Soundboard_LogSizes(board, boardName);
 }
 
 static struct Sound* Soundboard_PickRandom(struct Soundboard* board, uint8_t type) {
@@ -577,105 +599,211 @@ static struct Sound* Soundboard_PickRandom(struct Soundboard* board, uint8_t typ
 /*########################################################################################################################*
 *--------------------------------------------------------Sounds-----------------------------------------------------------*
 *#########################################################################################################################*/
-struct SoundOutput { AudioHandle Handle; void* Buffer; uint32_t BufferSize; };
-#define AUDIO_MAX_HANDLES 6
-#define HANDLE_INV -1
-#define SOUND_INV { HANDLE_INV, NULL, 0 }
+/* Sounds are mixed together on a separate thread into a single stereo output. */
+/* The game thread only queues up commands, so playing a sound is cheap and never blocks on audio APIs. */
+#define MIXER_SAMPLE_RATE 44100
+#define MIXER_FRAMES 1024
+#define MIXER_MAX_VOICES 32
+#define MIXER_MAX_COMMANDS 64
+
+struct SoundCommand { struct Sound* Snd; int SampleRate, Volume; };
+struct SoundVoice {
+	struct Sound* Snd;
+	/* Position and step through source frames, step fraction is 16 bits */
+	int Pos, Frames, StepInt;
+	uint32_t Frac, StepFrac;
+	int Volume; /* 0 to 256 */
+};
 
 static struct Soundboard digBoard, stepBoard;
-static struct SoundOutput monoOutputs[AUDIO_MAX_HANDLES]   = { SOUND_INV, SOUND_INV, SOUND_INV, SOUND_INV, SOUND_INV, SOUND_INV };
-static struct SoundOutput stereoOutputs[AUDIO_MAX_HANDLES] = { SOUND_INV, SOUND_INV, SOUND_INV, SOUND_INV, SOUND_INV, SOUND_INV };
+static AudioHandle sounds_out;
+static void* sounds_thread;
+static void* sounds_waitable;
+static void* sounds_lock;
+static volatile bool sounds_pendingStop, sounds_joining;
+
+static struct SoundCommand sounds_cmds[MIXER_MAX_COMMANDS];
+static int sounds_cmdsHead, sounds_cmdsCount;
+static struct SoundVoice sounds_voices[MIXER_MAX_VOICES];
+static int sounds_voicesCount;
+
+static void Mixer_AddVoice(struct SoundCommand* cmd) {
+	struct SoundVoice* v;
+	uint64_t step;
+	int i, remaining, best = 0, bestRemaining = Int32_MaxValue;
+
+	if (sounds_voicesCount < MIXER_MAX_VOICES) {
+		v = &sounds_voices[sounds_voicesCount++];
+	} else {
+		/* Replace the voice closest to finishing */
+		for (i = 0; i < MIXER_MAX_VOICES; i++) {
+			remaining = sounds_voices[i].Frames - sounds_voices[i].Pos;
+			if (remaining < bestRemaining) { best = i; bestRemaining = remaining; }
+		}
+		v = &sounds_voices[best];
+	}
 
-CC_NOINLINE static void Sounds_Fail(ReturnCode res) {
-	Logger_SimpleWarn(res, "playing sounds");
-	Chat_AddRaw("&cDisabling sounds");
-	Audio_SetSounds(0);
+	step = ((uint64_t)cmd->SampleRate << 16) / MIXER_SAMPLE_RATE;
+	v->Snd      = cmd->Snd;
+	v->Pos      = 0; v->Frac = 0;
+	v->Frames   = cmd->Snd->Size / (cmd->Snd->Format.Channels * (cmd->Snd->Format.BitsPerSample / 8));
+	v->StepInt  = (int)(step >> 16);
+	v->StepFrac = (uint32_t)(step & 0xFFFF);
+	v->Volume   = cmd->Volume * 256 / 100;
 }
 
-static void Sounds_PlayRaw(struct SoundOutput* output, struct Sound* snd, struct AudioFormat* fmt, int volume) {
-	void* data = snd->Data;
-	ReturnCode res;
-	if ((res = Audio_SetFormat(output->Handle, fmt))) { Sounds_Fail(res); return; }
-	
-	/* copy to temp buffer to apply volume */
-	if (volume < 100) {		
-		if (output->BufferSize < snd->Size) {
-			/* TODO: check if we can realloc NULL without a problem */
-			if (output->Buffer) {
-				output->Buffer = Mem_Realloc(output->Buffer, snd->Size, 1, "sound temp buffer");
-			} else {
-				output->Buffer = Mem_Alloc(snd->Size, 1, "sound temp buffer");
-			}
+static void Mixer_ProcessCommands(void) {
+	int i;
+	Mutex_Lock(sounds_lock);
+	{
+		for (i = 0; i < sounds_cmdsCount; i++) {
+			Mixer_AddVoice(&sounds_cmds[(sounds_cmdsHead + i) % MIXER_MAX_COMMANDS]);
 		}
-		data = output->Buffer;
+		sounds_cmdsHead  = (sounds_cmdsHead + sounds_cmdsCount) % MIXER_MAX_COMMANDS;
+		sounds_cmdsCount = 0;
+	}
+	Mutex_Unlock(sounds_lock);
+}
+
+#define Mixer_Sample(data, bits, i) (bits == 16 ? ((int16_t*)data)[i] : (((uint8_t*)data)[i] - 128) << 8)
+
+/* Resamples, applies volume to, then adds the given voice to the output. */
+/* Returns false if the voice has finished playing. */
+static bool Mixer_MixVoice(struct SoundVoice* v, int32_t* dst, int frames) {
+	uint8_t* data = v->Snd->Data;
+	int bits      = v->Snd->Format.BitsPerSample;
+	int channels  = v->Snd->Format.Channels;
+	int i, c, cur, next, frac, s0, s1, sample;
+
+	for (i = 0; i < frames; i++, dst += 2) {
+		if (v->Pos >= v->Frames) return false;
+		next = v->Pos + 1 < v->Frames ? v->Pos + 1 : v->Pos;
+		frac = v->Frac >> 1;
+
+		for (c = 0; c < channels; c++) {
+			cur  = v->Pos * channels + c;
+			s0   = Mixer_Sample(data, bits, cur);
+			s1   = Mixer_Sample(data, bits, next * channels + c);
 
-		Mem_Copy(data, snd->Data, snd->Size);
-		if (fmt->BitsPerSample == 8) {
-			Volume_Mix8((uint8_t*)data,  snd->Size,     volume);
-		} else {
-			Volume_Mix16((int16_t*)data, snd->Size / 2, volume);
+			/* Linearly interpolate between the two nearest source frames */
+			sample = s0 + (((s1 - s0) * frac) >> 15);
+			sample = (sample * v->Volume) >> 8;
+
+			if (channels == 1) { dst[0] += sample; dst[1] += sample; }
+			else { dst[c] += sample; }
 		}
+
+		v->Frac += v->StepFrac;
+		v->Pos  += v->StepInt + (v->Frac >> 16);
+		v->Frac &= 0xFFFF;
+	}
+	return v->Pos < v->Frames;
+}
+
+static void Mixer_Mix(int16_t* data, int frames) {
+	int32_t mixed[MIXER_FRAMES * 2] = { 0 };
+	int i, sample;
+
+	for (i = 0; i < sounds_voicesCount;) {
+		if (Mixer_MixVoice(&sounds_voices[i], mixed, frames)) { i++; continue; }
+		/* Voice finished, so move last voice into its slot */
+		sounds_voices[i] = sounds_voices[--sounds_voicesCount];
 	}
 
-	if ((res = Audio_BufferData(output->Handle, 0, data, snd->Size))) { Sounds_Fail(res); return; }
-	if ((res = Audio_Play(output->Handle)))                           { Sounds_Fail(res); return; }
+	for (i = 0; i < frames * 2; i++) {
+		sample  = mixed[i];
+		Math_Clamp(sample, -32768, 32767);
+		data[i] = (int16_t)sample;
+	}
+}
+
+static ReturnCode Mixer_Update(int16_t* data) {
+	bool completed, finished;
+	ReturnCode res;
+	int i;
+
+	for (i = 0; i < AUDIO_MAX_BUFFERS; i++) {
+		if ((res = Audio_IsCompleted(sounds_out, i, &completed))) return res;
+		if (!completed) continue;
+
+		Mixer_Mix(&data[MIXER_FRAMES * 2 * i], MIXER_FRAMES);
+		res = Audio_BufferData(sounds_out, i, &data[MIXER_FRAMES * 2 * i], MIXER_FRAMES * 4);
+		if (res) return res;
+		
+		/* Output stops when all buffers have been played, so restart it */
+		if ((res = Audio_IsFinished(sounds_out, &finished))) return res;
+		if (finished && (res = Audio_Play(sounds_out)))      return res;
+		if (!sounds_voicesCount) break;
+	}
+	return 0;
+}
+
+static void Sounds_RunLoop(void) {
+	static int16_t data[MIXER_FRAMES * 2 * AUDIO_MAX_BUFFERS];
+	struct AudioFormat fmt;
+	ReturnCode res = 0;
+
+	Audio_Open(&sounds_out, AUDIO_MAX_BUFFERS);
+	fmt.Channels      = 2;
+	fmt.BitsPerSample = 16;
+	fmt.SampleRate    = MIXER_SAMPLE_RATE;
+	res = Audio_SetFormat(sounds_out, &fmt);
+
+	while (!res && !sounds_pendingStop) {
+		Mixer_ProcessCommands();
+		/* Nothing to play, so wait until a sound is queued */
+		if (!sounds_voicesCount) { Waitable_Wait(sounds_waitable); continue; }
+
+		res = Mixer_Update(data);
+		if (sounds_voicesCount) Thread_Sleep(5);
+	}
+
+	if (res) {
+		Logger_SimpleWarn(res, "playing sounds");
+		Chat_AddRaw("&cDisabling sounds");
+		Audio_SoundsVolume = 0;
+	}
+	Audio_StopAndClose(sounds_out);
+	sounds_voicesCount = 0;
+
+	if (sounds_joining) return;
+	Thread_Detach(sounds_thread);
+	sounds_thread = NULL;
 }
 
 static void Sounds_Play(uint8_t type, struct Soundboard* board) {
+	struct SoundCommand* cmd;
 	struct Sound* snd;
-	struct AudioFormat  fmt;
-	struct SoundOutput* outputs;
-	struct SoundOutput* output;
-	struct AudioFormat* l;
+	int sampleRate, volume;
 
-	bool finished;
-	int i, volume;
-	ReturnCode res;
-
-	if (type == SOUND_NONE || !Audio_SoundsVolume) return;
+	if (type == SOUND_NONE || !Audio_SoundsVolume || !sounds_thread) return;
 	snd = Soundboard_PickRandom(board, type);
-	if (!snd) return;
+	if (!snd || snd->Format.Channels > 2) return;
 
-	fmt     = snd->Format;
-	volume  = Audio_SoundsVolume;
-	outputs = fmt.Channels == 1 ? monoOutputs : stereoOutputs;
+	sampleRate = snd->Format.SampleRate;
+	volume     = Audio_SoundsVolume;
 
 	if (board == &digBoard) {
-		if (type == SOUND_METAL) fmt.SampleRate = (fmt.SampleRate * 6) / 5;
-		else fmt.SampleRate = (fmt.SampleRate * 4) / 5;
+		if (type == SOUND_METAL) sampleRate = (sampleRate * 6) / 5;
+		else sampleRate = (sampleRate * 4) / 5;
 	} else {
 		volume /= 2;
-		if (type == SOUND_METAL) fmt.SampleRate = (fmt.SampleRate * 7) / 5;
+		if (type == SOUND_METAL) sampleRate = (sampleRate * 7) / 5;
 	}
 
-	/* Try to play on fresh device, or device with same data format */
-	for (i = 0; i < AUDIO_MAX_HANDLES; i++) {
-		output = &outputs[i];
-		if (output->Handle == HANDLE_INV) {
-			Audio_Open(&output->Handle, 1);
-		} else {
-			res = Audio_IsFinished(output->Handle, &finished);
-
-			if (res) { Sounds_Fail(res); return; }
-			if (!finished) continue;
-		}
-
-		l = Audio_GetFormat(output->Handle);
-		if (!l->Channels || AudioFormat_Eq(l, &fmt)) {
-			Sounds_PlayRaw(output, snd, &fmt, volume); return;
+	Mutex_Lock(sounds_lock);
+	{
+		/* Too many sounds queued up, just drop this one */
+		if (sounds_cmdsCount < MIXER_MAX_COMMANDS) {
+			cmd = &sounds_cmds[(sounds_cmdsHead + sounds_cmdsCount) % MIXER_MAX_COMMANDS];
+			cmd->Snd        = snd;
+			cmd->SampleRate = sampleRate;
+			cmd->Volume     = volume;
+			sounds_cmdsCount++;
 		}
 	}
-
-	/* Try again with all devices, even if need to recreate one (expensive) */
-	for (i = 0; i < AUDIO_MAX_HANDLES; i++) {
-		output = &outputs[i];
-		res = Audio_IsFinished(output->Handle, &finished);
-
-		if (res) { Sounds_Fail(res); return; }
-		if (!finished) continue;
-
-		Sounds_PlayRaw(output, snd, &fmt, volume); return;
-	}
+	Mutex_Unlock(sounds_lock);
+	Waitable_Signal(sounds_waitable);
 }
 
 static void Audio_PlayBlockSound(void* obj, IVec3 coords, BlockID old, BlockID now) {
@@ -686,32 +814,28 @@ static void Audio_PlayBlockSound(void* obj, IVec3 coords, BlockID old, BlockID n
 	}
 }
 
-static void Sounds_FreeOutputs(struct SoundOutput* outputs) {
-	int i;
-	for (i = 0; i < AUDIO_MAX_HANDLES; i++) {
-		if (outputs[i].Handle == HANDLE_INV) continue;
-
-		Audio_StopAndClose(outputs[i].Handle);
-		outputs[i].Handle = HANDLE_INV;
-
-		Mem_Free(outputs[i].Buffer);
-		outputs[i].Buffer     = NULL;
-		outputs[i].BufferSize = 0;
-	}
-}
-
 static void Sounds_Init(void) {
 	static const String dig  = String_FromConst("dig_");
 	static const String step = String_FromConst("step_");
 
-	if (digBoard.Count || stepBoard.Count) return;
-	Soundboard_Init(&digBoard,  &dig,  &files);
-	Soundboard_Init(&stepBoard, &step, &files);
+	if (!digBoard.Count && !stepBoard.Count) {
+		Soundboard_Init(&digBoard,  &dig,  &files);
+		Soundboard_Init(&stepBoard, &step, &files);
+	}
+
+	if (sounds_thread) return;
+	sounds_joining     = false;
+	sounds_pendingStop = false;
+	sounds_thread = Thread_Start(Sounds_RunLoop, false);
 }
 
 static void Sounds_Free(void) {
-	Sounds_FreeOutputs(monoOutputs);
-	Sounds_FreeOutputs(stereoOutputs);
+	sounds_joining     = true;
+	sounds_pendingStop = true;
+	Waitable_Signal(sounds_waitable);
+
+	if (sounds_thread) Thread_Join(sounds_thread);
+	sounds_thread = NULL;
 }
 
 void Audio_SetSounds(int volume) {
@@ -731,6 +855,24 @@ static AudioHandle music_out;
 static void* music_thread;
 static void* music_waitable;
 static volatile bool music_pendingStop, music_joining;
+/* Output buffers are kept between songs, rather than reallocated for every song */
+static int16_t* music_data;
+static int music_dataSize;
+
+static int16_t* Music_GetBuffers(int samples) {
+	if (samples <= music_dataSize) return music_data;
+	Mem_Free(music_data);
+
+	music_data     = (int16_t*)Mem_Alloc(samples, 2, "Ogg final output");
+	music_dataSize = samples;
+	return music_data;
+}
+
+static void Music_FreeBuffers(void) {
+	Mem_Free(music_data);
+	music_data     = NULL;
+	music_dataSize = 0;
+}
 
 static ReturnCode Music_Buffer(int i, int16_t* data, int maxSamples, struct VorbisState* ctx) {
 	int samples = 0;
@@ -775,7 +917,7 @@ static ReturnCode Music_PlayOgg(struct Stream* source) {
 	/* so we may end up decoding slightly over a second of audio */
 	chunkSize        = fmt.Channels * (fmt.SampleRate + vorbis.blockSizes[1]);
 	samplesPerSecond = fmt.Channels * fmt.SampleRate;
-	data = (int16_t*)Mem_Alloc(chunkSize * AUDIO_MAX_BUFFERS, 2, "Ogg final output");
+	data = Music_GetBuffers(chunkSize * AUDIO_MAX_BUFFERS);
 
 	/* fill up with some samples before playing */
 	for (i = 0; i < AUDIO_MAX_BUFFERS && !res; i++) {
@@ -811,7 +953,6 @@ static ReturnCode Music_PlayOgg(struct Stream* source) {
 	}
 
 cleanup:
-	Mem_Free(data);
 	Vorbis_Free(&vorbis);
 	return res == ERR_END_OF_STREAM ? 0 : res;
 }
@@ -869,6 +1010,7 @@ static void Music_RunLoop(void) {
 		Audio_MusicVolume = 0;
 	}
 	Audio_StopAndClose(music_out);
+	Music_FreeBuffers();
 
 	if (music_joining) return;
 	Thread_Detach(music_thread);
@@ -921,7 +1063,9 @@ static void Audio_Init(void) {
 	int volume;
 
 	Directory_Enum(&path, NULL, Audio_FilesCallback);
-	music_waitable = Waitable_Create();
+	music_waitable  = Waitable_Create();
+	sounds_waitable = Waitable_Create();
+	sounds_lock     = Mutex_Create();
 	Audio_SysInit();
 
 	volume = Audio_LoadVolume(OPT_MUSIC_VOLUME, OPT_USE_MUSIC);
@@ -935,6 +1079,8 @@ static void Audio_Free(void) {
 	Music_Free();
 	Sounds_Free();
 	Waitable_Free(music_waitable);
+	Waitable_Free(sounds_waitable);
+	Mutex_Free(sounds_lock);
 	Audio_SysFree();
 	Event_UnregisterBlock(&UserEvents.BlockChanged, NULL, Audio_PlayBlockSound);
 }
@@ -313,6 +313,27 @@ static void Png_ComputeTransparency(Bitmap* bmp, BitmapCol col) {
 /* Need to store both current and prior row, per PNG specification. */
 #define PNG_BUFFER_SIZE ((PNG_MAX_DIMS * 2 * 4 + 1) * 2)
 
+static ReturnCode Png_DecodedClose(struct Stream* s) { return 0; }
+void Png_MakeDecodedStream(struct Stream* s, uint8_t* data, uint32_t len, Bitmap* bmp) {
+	Stream_ReadonlyMemory(s, data, len);
+	s->Close = Png_DecodedClose;
+	s->Meta.Decoded.Bmp = bmp;
+}
+
+/* Takes the already decoded bitmap from a stream made by Png_MakeDecodedStream. */
+static bool Png_TakeDecoded(Bitmap* bmp, struct Stream* stream) {
+	Bitmap* src;
+	if (stream->Close != Png_DecodedClose) return false;
+
+	src = (Bitmap*)stream->Meta.Decoded.Bmp;
+	if (!src || !src->Scan0) return false;
+
+	*bmp = *src;
+	src->Scan0 = NULL;
+	stream->Meta.Decoded.Bmp = NULL;
+	return true;
+}
+
 /* TODO: Test a lot of .png files and ensure output is right */
 ReturnCode Png_Decode(Bitmap* bmp, struct Stream* stream) {
 	uint8_t tmp[PNG_PALETTE * 3];
@@ -342,6 +363,7 @@ ReturnCode Png_Decode(Bitmap* bmp, struct Stream* stream) {
 	struct Stream compStream, datStream;
 	struct ZLibHeader zlibHeader;
 
+	if (Png_TakeDecoded(bmp, stream)) return 0;
 	bmp->Width = 0; bmp->Height = 0;
 	bmp->Scan0 = NULL;
 
@@ -65,6 +65,10 @@ typedef int (*Png_RowSelector)(Bitmap* bmp, int row);
      https://github.com/nothings/stb/blob/master/stb_image.h
 */
 CC_API ReturnCode Png_Decode(Bitmap* bmp, struct Stream* stream);
+/* Wraps the raw data of a .png image, along with the bitmap it was already decoded into. */
+/* Png_Decode on the stream then takes ownership of the bitmap, instead of decoding the data again. */
+/* NOTE: Used to decode images on a background thread, while still raising events on the main thread. */
+void Png_MakeDecodedStream(struct Stream* s, uint8_t* data, uint32_t len, Bitmap* bmp);
 /* Encodes a bitmap in PNG format. */
 /* selectRow is optional. Can be used to modify how rows are encoded. (e.g. flip image) */
 /* if alpha is non-zero, RGBA channels are saved, otherwise only RGB channels are. */
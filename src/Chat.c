@@ -15,6 +15,7 @@
 #include "EnvRenderer.h"
 #include "GameStructs.h"
 #include "Utils.h"
+#include "Profiler.h"
 
 static char msgs[10][STRING_SIZE];
 String Chat_Status[4]       = { String_FromArray(msgs[0]), String_FromArray(msgs[1]), String_FromArray(msgs[2]), String_FromArray(msgs[3]) };
@@ -23,35 +24,75 @@ String Chat_ClientStatus[2] = { String_FromArray(msgs[7]), String_FromArray(msgs
 
 String Chat_Announcement = String_FromArray(msgs[9]);
 TimeMS Chat_AnnouncementReceived;
-StringsBuffer Chat_Log, Chat_InputLog;
+StringsBuffer Chat_InputLog;
 bool Chat_Logging;
 
 /*########################################################################################################################*
-*-------------------------------------------------------Chat logging------------------------------------------------------*
+*-------------------------------------------------------Chat history------------------------------------------------------*
 *#########################################################################################################################*/
-#define CHAT_LOGTIMES_DEF_ELEMS 256
-static TimeMS defaultLogTimes[CHAT_LOGTIMES_DEF_ELEMS];
-static TimeMS* logTimes = defaultLogTimes;
-static int logTimesCapacity = CHAT_LOGTIMES_DEF_ELEMS, logTimesCount;
+/* Only the most recent messages are kept, in a fixed size ring */
+#define CHAT_LOG_LEN (STRING_SIZE * 2)
+static char logMsgs[CHAT_LOG_MAX][CHAT_LOG_LEN];
+/* Messages longer than CHAT_LOG_LEN are instead stored in a separate heap buffer */
+static char* logLongMsgs[CHAT_LOG_MAX];
+static uint16_t logLens[CHAT_LOG_MAX];
+static TimeMS logTimes[CHAT_LOG_MAX];
+int Chat_LogCount;
+
+/* Whether the ith message is still in the ring */
+#define Chat_IsLogKept(i) ((i) >= 0 && (i) < Chat_LogCount && (i) >= Chat_LogCount - CHAT_LOG_MAX)
+
+String Chat_GetLog(int i) {
+	if (!Chat_IsLogKept(i)) return String_Empty;
+	i &= CHAT_LOG_MAX - 1;
+
+	if (logLongMsgs[i]) return String_Init(logLongMsgs[i], logLens[i], logLens[i]);
+	return String_Init(logMsgs[i], logLens[i], CHAT_LOG_LEN);
+}
 
 TimeMS Chat_GetLogTime(int i) {
-	if (i < 0 || i >= logTimesCount) Logger_Abort("Tried to get time past LogTime end");
-	return logTimes[i];
+	if (!Chat_IsLogKept(i)) return 0;
+	return logTimes[i & (CHAT_LOG_MAX - 1)];
 }
 
-static void Chat_AppendLogTime(void) {
-	TimeMS now = DateTime_CurrentUTC_MS();
+static void Chat_AppendHistory(const String* text) {
+	int i     = Chat_LogCount & (CHAT_LOG_MAX - 1);
+	int len   = text->length;
+	char* dst = logMsgs[i];
+
+	/* Overwrites the oldest message in the ring */
+	Mem_Free(logLongMsgs[i]);
+	logLongMsgs[i] = NULL;
+
+	if (len > CHAT_LOG_LEN) {
+		dst = (char*)Mem_Alloc(len, 1, "chat history message");
+		logLongMsgs[i] = dst;
+	}
+
+	Mem_Copy(dst, text->buffer, len);
+	logLens[i]  = len;
+	logTimes[i] = DateTime_CurrentUTC_MS();
+	Chat_LogCount++;
+}
 
-	if (logTimesCount == logTimesCapacity) {
-		Utils_Resize((void**)&logTimes, &logTimesCapacity,
-					sizeof(TimeMS), CHAT_LOGTIMES_DEF_ELEMS, 512);
+static void Chat_FreeHistory(void) {
+	int i;
+	for (i = 0; i < CHAT_LOG_MAX; i++) {
+		Mem_Free(logLongMsgs[i]);
+		logLongMsgs[i] = NULL;
 	}
-	logTimes[logTimesCount++] = now;
+	Chat_LogCount = 0;
 }
 
+
+/*########################################################################################################################*
+*-------------------------------------------------------Chat logging------------------------------------------------------*
+*#########################################################################################################################*/
+
 #ifdef CC_BUILD_WEB
 static void Chat_ResetLog(void) { }
 static void Chat_CloseLog(void) { }
+static void Chat_StopLogWorker(void) { }
 void Chat_SetLogName(const String* name) { }
 static void Chat_OpenLog(struct DateTime* now) { }
 static void Chat_AppendLog(const String* text) { }
@@ -64,6 +105,127 @@ static String logPath = String_FromArray(logPathBuffer);
 static struct Stream logStream;
 static struct DateTime lastLogDate;
 
+/* Lines are queued by the main thread, then written to disc in batches by a background thread */
+#define CHAT_LOGQUEUE_SIZE 16384
+static uint8_t logQueue[CHAT_LOGQUEUE_SIZE], logWriteBuffer[CHAT_LOGQUEUE_SIZE];
+static int logQueueLen;
+static void* logThread;
+static void* logMutex;
+static void* logQueuedWaitable;  /* signalled when lines are added to the queue */
+static void* logWrittenWaitable; /* signalled after a batch of lines is written */
+static volatile bool logTerminate;
+static bool logWriting;
+static ReturnCode logWriteRes;
+
+static void Chat_LogWorker(void) {
+	ReturnCode res;
+	bool stop;
+	int len;
+
+	for (;;) {
+		Mutex_Lock(logMutex);
+		{
+			len  = logQueueLen;
+			stop = logTerminate;
+			Mem_Copy(logWriteBuffer, logQueue, len);
+			logQueueLen = 0;
+			logWriting  = len > 0;
+		}
+		Mutex_Unlock(logMutex);
+
+		if (len) {
+			res = Stream_Write(&logStream, logWriteBuffer, len);
+			Mutex_Lock(logMutex);
+			{
+				if (res && !logWriteRes) logWriteRes = res;
+				logWriting = false;
+			}
+			Mutex_Unlock(logMutex);
+			Waitable_Signal(logWrittenWaitable);
+		} else if (stop) {
+			return;
+		} else {
+			Waitable_Wait(logQueuedWaitable);
+		}
+	}
+}
+
+/* Blocks until all queued lines have been written to disc */
+static void Chat_FlushLog(void) {
+	bool pending;
+	if (!logThread) return;
+
+	for (;;) {
+		Mutex_Lock(logMutex);
+		pending = logQueueLen || logWriting;
+		Mutex_Unlock(logMutex);
+
+		if (!pending) return;
+		Waitable_Signal(logQueuedWaitable);
+		Waitable_Wait(logWrittenWaitable);
+	}
+}
+
+static void Chat_QueueLog(const String* line) {
+	const char* nl;
+	int i, maxLen;
+	bool full;
+	/* each character is at most 3 bytes in UTF8 */
+	maxLen = line->length * 3 + 2;
+
+	if (!logThread) {
+		logMutex           = Mutex_Create();
+		logQueuedWaitable  = Waitable_Create();
+		logWrittenWaitable = Waitable_Create();
+		logThread          = Thread_Start(Chat_LogWorker, false);
+	}
+	Mutex_Lock(logMutex);
+	full = logQueueLen + maxLen > CHAT_LOGQUEUE_SIZE;
+	Mutex_Unlock(logMutex);
+	if (full) Chat_FlushLog();
+
+	Mutex_Lock(logMutex);
+	{
+		for (i = 0; i < line->length; i++) {
+			logQueueLen += Convert_CP437ToUtf8(line->buffer[i], logQueue + logQueueLen);
+		}
+		for (nl = _NL; *nl; nl++) { logQueue[logQueueLen++] = *nl; }
+	}
+	Mutex_Unlock(logMutex);
+	Waitable_Signal(logQueuedWaitable);
+}
+
+/* Returns the first error the writer thread had since this was last called, then clears it */
+static ReturnCode Chat_TakeLogWriteError(void) {
+	ReturnCode res;
+	/* Without a writer thread, nothing else can be accessing it */
+	if (!logThread) { res = logWriteRes; logWriteRes = 0; return res; }
+
+	Mutex_Lock(logMutex);
+	{
+		res = logWriteRes;
+		logWriteRes = 0;
+	}
+	Mutex_Unlock(logMutex);
+	return res;
+}
+
+/* Stops the background log writer thread, after it has written all queued lines */
+static void Chat_StopLogWorker(void) {
+	if (!logThread) return;
+	Chat_FlushLog();
+
+	logTerminate = true;
+	Waitable_Signal(logQueuedWaitable);
+	Thread_Join(logThread);
+
+	Mutex_Free(logMutex);
+	Waitable_Free(logQueuedWaitable);
+	Waitable_Free(logWrittenWaitable);
+	logThread    = NULL;
+	logTerminate = false;
+}
+
 static void Chat_ResetLog(void) {
 	logName.length = 0;
 	lastLogDate.Day   = 0;
@@ -75,6 +237,7 @@ static void Chat_CloseLog(void) {
 	ReturnCode res;
 	if (!logStream.Meta.File) return;
 
+	Chat_FlushLog();
 	res = logStream.Close(&logStream);
 	if (res) { Logger_Warn2(res, "closing", &logPath); }
 }
@@ -148,6 +311,13 @@ static void Chat_AppendLog(const String* text) {
 	if (!logName.length || !Chat_Logging) return;
 	DateTime_CurrentLocal(&now);
 
+	/* a previous batch of lines failed to be written by the writer thread */
+	if ((res = Chat_TakeLogWriteError())) {
+		Chat_DisableLogging();
+		Logger_Warn2(res, "writing to", &logPath);
+		return;
+	}
+
 	if (now.Day != lastLogDate.Day || now.Month != lastLogDate.Month || now.Year != lastLogDate.Year) {
 		Chat_CloseLog();
 		Chat_OpenLog(&now);
@@ -160,11 +330,7 @@ static void Chat_AppendLog(const String* text) {
 	String_InitArray(str, strBuffer);
 	String_Format3(&str, "[%p2:%p2:%p2] ", &now.Hour, &now.Minute, &now.Second);
 	String_AppendColorless(&str, text);
-
-	res = Stream_WriteLine(&logStream, &str);
-	if (!res) return;
-	Chat_DisableLogging();
-	Logger_Warn2(res, "writing to", &logPath);
+	Chat_QueueLog(&str);
 }
 #endif
 
@@ -193,9 +359,8 @@ void Chat_Add(const String* text) { Chat_AddOf(text, MSG_TYPE_NORMAL); }
 
 void Chat_AddOf(const String* text, int msgType) {
 	if (msgType == MSG_TYPE_NORMAL) {
-		StringsBuffer_Add(&Chat_Log, text);
+		Chat_AppendHistory(text);
 		Chat_AppendLog(text);
-		Chat_AppendLogTime();
 	} else if (msgType >= MSG_TYPE_STATUS_1 && msgType <= MSG_TYPE_STATUS_3) {
 		/* Status[0] is for texture pack downloading message */
 		String_Copy(&Chat_Status[1 + (msgType - MSG_TYPE_STATUS_1)], text);
@@ -412,6 +577,71 @@ static struct ChatCommand ResolutionCommand = {
 	}
 };
 
+static void ProfileCommand_Execute(const String* args, int argsCount) {
+	static const String path = String_FromConst("profile.csv");
+	ReturnCode res;
+
+	if (!argsCount) {
+		Profiler_ShowOverlay = !Profiler_ShowOverlay;
+		Chat_Add1("&e/client: &fProfiler overlay is now %c.", Profiler_ShowOverlay ? "ON" : "OFF");
+	} else if (!String_CaselessEqualsConst(&args[0], "csv")) {
+		Chat_Add1("&e/client: &cUnrecognised option &f\"%s\"&c.", &args[0]);
+	} else if (Profiler_WritingCSV()) {
+		Profiler_StopCSV();
+		Chat_Add1("&e/client: &fStopped writing frame timings to %s.", &path);
+	} else if ((res = Profiler_StartCSV(&path))) {
+		Logger_Warn2(res, "creating", &path);
+	} else {
+		Chat_Add1("&e/client: &fWriting frame timings to %s.", &path);
+	}
+}
+
+static struct ChatCommand ProfileCommand = {
+	"Profile", ProfileCommand_Execute, false,
+	{
+		"&a/client profile [csv]",
+		"&eToggles showing how long each part of a frame takes.",
+		"&bcsv: &eToggles writing timings of every frame to profile.csv",
+	}
+};
+
+#ifdef CC_BUILD_MEMTRACK
+static void MemCommand_Execute(const String* args, int argsCount) {
+	static struct MemTag tags[MEM_MAX_TAGS];
+	struct MemTag tmp;
+	uint64_t live, peak;
+	int i, j, count, liveKB, peakKB;
+	bool byPeak = argsCount && String_CaselessEqualsConst(&args[0], "peak");
+
+	count  = Mem_GetTags(tags, &live, &peak);
+	liveKB = (int)(live / 1024); peakKB = (int)(peak / 1024);
+	Chat_Add2("&e/client: &f%i KB allocated, peak of %i KB", &liveKB, &peakKB);
+
+	/* Only the largest few tags are shown, so a simple insertion sort is fine */
+	for (i = 1; i < count; i++) {
+		tmp = tags[i];
+		for (j = i - 1; j >= 0 && (byPeak ? tags[j].Peak < tmp.Peak : tags[j].Live < tmp.Live); j--) {
+			tags[j + 1] = tags[j];
+		}
+		tags[j + 1] = tmp;
+	}
+
+	for (i = 0; i < count && i < 8; i++) {
+		liveKB = (int)(tags[i].Live / 1024); peakKB = (int)(tags[i].Peak / 1024);
+		Chat_Add3("&7  %c: &f%i KB, peak %i KB", tags[i].Place, &liveKB, &peakKB);
+	}
+}
+
+static struct ChatCommand MemCommand = {
+	"Mem", MemCommand_Execute, false,
+	{
+		"&a/client mem [peak]",
+		"&eShows which parts of the game have allocated the most memory.",
+		"&bpeak: &eSorts by most memory ever allocated at once instead.",
+	}
+};
+#endif
+
 static void ModelCommand_Execute(const String* args, int argsCount) {
 	if (argsCount) {
 		Entity_SetModel(&LocalPlayer_Instance.Base, &args[0]);
@@ -586,6 +816,10 @@ static void Chat_Init(void) {
 	Commands_Register(&HelpCommand);
 	Commands_Register(&RenderTypeCommand);
 	Commands_Register(&ResolutionCommand);
+	Commands_Register(&ProfileCommand);
+#ifdef CC_BUILD_MEMTRACK
+	Commands_Register(&MemCommand);
+#endif
 	Commands_Register(&ModelCommand);
 	Commands_Register(&CuboidCommand);
 	Commands_Register(&TeleportCommand);
@@ -609,13 +843,10 @@ static void Chat_Reset(void) {
 
 static void Chat_Free(void) {
 	Chat_CloseLog();
+	Chat_StopLogWorker();
 	cmds_head = NULL;
 
-	if (logTimes != defaultLogTimes) Mem_Free(logTimes);
-	logTimes      = defaultLogTimes;
-	logTimesCount = 0;
-
-	StringsBuffer_Clear(&Chat_Log);
+	Chat_FreeHistory();
 	StringsBuffer_Clear(&Chat_InputLog);
 }
 
@@ -21,13 +21,20 @@ enum MsgType {
 };
 
 extern String Chat_Status[4], Chat_BottomRight[3], Chat_ClientStatus[2], Chat_Announcement;
-extern StringsBuffer Chat_Log, Chat_InputLog;
+extern StringsBuffer Chat_InputLog;
 /* Whether chat messages are logged to disc. */
 extern bool Chat_Logging;
 
 /* Time at which last announcement message was received. */
 extern TimeMS Chat_AnnouncementReceived;
-/* Gets the time the ith chat message was received at. */
+/* Max number of recent chat messages kept in memory. (must be power of two) */
+#define CHAT_LOG_MAX 512
+/* Total number of normal chat messages received. */
+/* NOTE: Only the most recent CHAT_LOG_MAX of these messages are kept. */
+extern int Chat_LogCount;
+/* Gets the ith chat message, or an empty string if it is no longer kept. */
+String Chat_GetLog(int i);
+/* Gets the time the ith chat message was received at, or 0 if it is no longer kept. */
 TimeMS Chat_GetLogTime(int i);
 
 struct ChatCommand;
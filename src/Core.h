@@ -82,8 +82,18 @@ typedef uint16_t TextureLoc;
 typedef uint8_t TextureLoc;
 #endif
 
+/* Maximum number of entities. Can be raised at build time (e.g. -DENTITIES_MAX_COUNT=1024) */
+/* for servers that use extended entity IDs, in which case EntityID also becomes 16 bit. */
+#ifndef ENTITIES_MAX_COUNT
+#define ENTITIES_MAX_COUNT 256
+#endif
+
 typedef uint8_t BlockRaw;
+#if ENTITIES_MAX_COUNT > 256
+typedef uint16_t EntityID;
+#else
 typedef uint8_t EntityID;
+#endif
 typedef uint8_t Face;
 typedef uint32_t ReturnCode;
 typedef uint64_t TimeMS;
@@ -94,6 +104,8 @@ typedef struct FontDesc_ { void* Handle; uint16_t Size, Style; } FontDesc;
 typedef struct TextureRec_ { float U1, V1, U2, V2; } TextureRec;
 
 /*#define CC_BUILD_GL11*/
+/* Counts Mem_Alloc allocations by place (see Mem_GetTags), at the cost of extra memory and time per allocation */
+/*#define CC_BUILD_MEMTRACK*/
 #ifndef CC_BUILD_MANUAL
 #if defined _WIN32
 #define CC_BUILD_WIN
@@ -1182,6 +1182,9 @@ static ReturnCode Zip_ReadCentralDirectory(struct ZipState* state) {
 	commentLen = Stream_GetU16_LE(&header[28]);
 	if ((res = stream->Skip(stream, extraLen + commentLen))) return res;
 
+	/* directories have no data, so no point processing them */
+	if (pathLen && pathBuffer[pathLen - 1] == '/') return 0;
+
 	if (!state->SelectEntry(&path)) return 0;
 	if (state->_usedEntries >= ZIP_MAX_ENTRIES) return ZIP_ERR_TOO_MANY_ENTRIES;
 	entry = &state->Entries[state->_usedEntries++];
@@ -1211,6 +1214,30 @@ enum ZipSig {
 	ZIP_SIG_LOCALFILEHEADER = 0x04034b50
 };
 
+static void Zip_SortEntries(struct ZipEntry* keys, int left, int right) {
+	struct ZipEntry key;
+
+	while (left < right) {
+		int i = left, j = right;
+		uint32_t pivot = keys[(i + j) >> 1].LocalHeaderOffset;
+
+		/* partition the list */
+		while (i <= j) {
+			while (pivot > keys[i].LocalHeaderOffset) i++;
+			while (pivot < keys[j].LocalHeaderOffset) j--;
+			QuickSort_Swap_Maybe();
+		}
+		/* recurse into the smaller subset */
+		if (j - left <= right - i) {
+			if (left < j) { Zip_SortEntries(keys, left, j); }
+			left = i;
+		} else {
+			if (i < right) { Zip_SortEntries(keys, i, right); }
+			right = j;
+		}
+	}
+}
+
 static ReturnCode Zip_DefaultProcessor(const String* path, struct Stream* data, struct ZipState* s) { return 0; }
 static bool Zip_DefaultSelector(const String* path) { return true; }
 void Zip_Init(struct ZipState* state, struct Stream* input) {
@@ -1261,6 +1288,9 @@ ReturnCode Zip_Extract(struct ZipState* state) {
 		}
 	}
 
+	/* Visit entries in the order they are stored, so the archive is read sequentially */
+	if (state->_usedEntries) Zip_SortEntries(state->Entries, 0, state->_usedEntries - 1);
+
 	/* Now read the local file header entries */
 	for (i = 0; i < state->_usedEntries; i++) {
 		struct ZipEntry* entry = &state->Entries[i];
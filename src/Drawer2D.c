@@ -617,6 +617,248 @@ void Drawer2D_DrawClippedText(Bitmap* bmp, struct DrawTextArgs* args, int x, int
 }
 
 
+/*########################################################################################################################*
+*-------------------------------------------------------Glyph atlas-------------------------------------------------------*
+*#########################################################################################################################*/
+/* Characters are rasterised once into a shared atlas texture, then text is drawn as a batch of quads from that atlas */
+#define GLYPH_ATLAS_SIZE 1024
+#define GLYPH_MAX_FONTS  8
+#define GLYPH_MAX_QUADS  1024
+#define GLYPH_LAYER_MAIN   0
+#define GLYPH_LAYER_SHADOW 1
+
+struct Glyph { int16_t X, Y, Width, Height, OffsetX, OffsetY, Advance; bool Cached; };
+struct GlyphFont { FontDesc Desc; bool Bitmapped; struct Glyph Glyphs[2][256]; };
+
+static struct GlyphFont glyph_fonts[GLYPH_MAX_FONTS];
+static int glyph_fontsCount;
+static GfxResourceID glyph_tex, glyph_vb;
+/* Shelf packer state, glyphs are packed left to right in rows */
+static int glyph_size, glyph_curX, glyph_curY, glyph_rowHeight;
+static VertexP3fT2fC4b glyph_vertices[GLYPH_MAX_QUADS * 4];
+static int glyph_quads;
+
+/* Forgets all cached glyphs, so they are rasterised again when next drawn */
+static void GlyphAtlas_Reset(void) {
+	glyph_fontsCount = 0;
+	glyph_curX = 0; glyph_curY = 0; glyph_rowHeight = 0;
+}
+
+static struct GlyphFont* GlyphAtlas_FindFont(const FontDesc* desc) {
+	struct GlyphFont* font;
+	int i;
+
+	for (i = 0; i < glyph_fontsCount; i++) {
+		font = &glyph_fonts[i];
+		if (font->Desc.Handle != desc->Handle || font->Desc.Size != desc->Size) continue;
+		if (font->Desc.Style == desc->Style && font->Bitmapped == Drawer2D_BitmappedText) return font;
+	}
+
+	if (glyph_fontsCount == GLYPH_MAX_FONTS) {
+		Drawer2D_FlushGlyphs();
+		GlyphAtlas_Reset();
+	}
+	font = &glyph_fonts[glyph_fontsCount++];
+
+	font->Desc      = *desc;
+	font->Bitmapped = Drawer2D_BitmappedText;
+	Mem_Set(font->Glyphs, 0, sizeof(font->Glyphs));
+	return font;
+}
+
+/* Finds space in the atlas for a glyph of the given size */
+static bool GlyphAtlas_Alloc(int width, int height, int* x, int* y) {
+	/* leave a 1 pixel gap around glyphs, to avoid bleeding into neighbours */
+	if (glyph_curX + width > glyph_size) {
+		glyph_curX = 0; glyph_curY += glyph_rowHeight; glyph_rowHeight = 0;
+	}
+	if (glyph_curY + height > glyph_size) return false;
+
+	*x = glyph_curX; glyph_curX += width + 1;
+	*y = glyph_curY; glyph_rowHeight = max(glyph_rowHeight, height + 1);
+	return true;
+}
+
+/* Draws a single character in white, returning how far the pen should then advance */
+static int GlyphAtlas_Rasterise(Bitmap* bmp, struct DrawTextArgs* args, int x, int y, int layer) {
+	BitmapCol white = BITMAPCOL_CONST(255, 255, 255, 255);
+	BitmapCol col;
+	int point = args->font.Size;
+
+	if (!Drawer2D_BitmappedText) {
+		return Platform_TextDraw(args, bmp, x, y, white, layer == GLYPH_LAYER_SHADOW);
+	}
+
+	/* bitmapped text starts off using colour of &f */
+	col = Drawer2D_Cols['f'];
+	Drawer2D_Cols['f'] = white;
+	Drawer2D_DrawCore(bmp, args, x, y, false);
+	Drawer2D_Cols['f'] = col;
+	return Drawer2D_Width(point, args->text.buffer[0]) + Drawer2D_XPadding(point);
+}
+
+/* Returns the cached glyph for the given character, rasterising it into the atlas if needed */
+/* NOTE: Returns NULL when the atlas has no room left for the glyph */
+static struct Glyph* GlyphAtlas_Get(struct GlyphFont* font, char c, int layer) {
+	struct Glyph* g = &font->Glyphs[layer][(uint8_t)c];
+	struct Glyph* normal;
+	struct DrawTextArgs args;
+	Bitmap bmp, part;
+	BitmapCol* row;
+	int minX, minY, maxX, maxY;
+	int x, y, yy, penX, penY, advance, offset;
+
+	if (g->Cached) return g;
+	/* shadow of bitmapped text is just the normal glyph, drawn slightly offset */
+	if (font->Bitmapped && layer == GLYPH_LAYER_SHADOW) {
+		normal = GlyphAtlas_Get(font, c, GLYPH_LAYER_MAIN);
+		if (!normal) return NULL;
+
+		offset = Drawer2D_ShadowOffset(font->Desc.Size);
+		*g = *normal;
+		g->OffsetX += offset; g->OffsetY += offset;
+		return g;
+	}
+
+	args.text = String_Init(&c, 1, 1);
+	args.font = font->Desc; args.useShadow = false;
+	/* leave plenty of room around the pen, as some glyphs extend before/above it */
+	penY = Drawer2D_FontHeight(&font->Desc, true);
+	penX = penY;
+	Bitmap_Init(bmp, penX * 3, penY * 2, NULL);
+	bmp.Scan0 = (uint8_t*)Mem_AllocCleared(bmp.Width * bmp.Height, 4, "glyph bitmap");
+	penY /= 2;
+	advance = GlyphAtlas_Rasterise(&bmp, &args, penX, penY, layer);
+
+	minX = bmp.Width; maxX = -1;
+	minY = bmp.Height; maxY = -1;
+	for (y = 0; y < bmp.Height; y++) {
+		row = Bitmap_GetRow(&bmp, y);
+		for (x = 0; x < bmp.Width; x++) {
+			if (!row[x].A) continue;
+			minX = min(minX, x); maxX = max(maxX, x);
+			minY = min(minY, y); maxY = max(maxY, y);
+		}
+	}
+
+	g->Width = 0; g->Height = 0;
+	if (maxX >= 0) {
+		g->Width  = maxX - minX + 1;
+		g->Height = maxY - minY + 1;
+		if (!GlyphAtlas_Alloc(g->Width, g->Height, &x, &y)) { Mem_Free(bmp.Scan0); return NULL; }
+
+		Bitmap_Allocate(&part, g->Width, g->Height);
+		for (yy = 0; yy < g->Height; yy++) {
+			Mem_Copy(Bitmap_GetRow(&part, yy), Bitmap_GetRow(&bmp, minY + yy) + minX, g->Width * 4);
+		}
+		Gfx_UpdateTexturePart(glyph_tex, x, y, &part, false);
+		Mem_Free(part.Scan0);
+
+		g->X = x; g->OffsetX = minX - penX;
+		g->Y = y; g->OffsetY = minY - penY;
+	}
+
+	Mem_Free(bmp.Scan0);
+	g->Advance = advance;
+	g->Cached  = true;
+	return g;
+}
+
+static PackedCol GlyphAtlas_Tint(BitmapCol col, int layer) {
+	BitmapCol black = BITMAPCOL_CONST(0, 0, 0, 255);
+	PackedCol tint;
+
+	if (layer == GLYPH_LAYER_SHADOW) {
+		col = Drawer2D_BlackTextShadows ? black : BitmapCol_Scale(col, 0.25f);
+	}
+	tint.R = col.R; tint.G = col.G; tint.B = col.B; tint.A = 255;
+	return tint;
+}
+
+static void GlyphAtlas_DrawLayer(struct DrawTextArgs* args, int x, int y, int layer) {
+	String text = args->text;
+	struct GlyphFont* font;
+	struct Glyph* g;
+	struct Texture tex;
+	VertexP3fT2fC4b* ptr;
+	PackedCol tint;
+	float scale;
+	int i; char c;
+
+	font  = GlyphAtlas_FindFont(&args->font);
+	tint  = GlyphAtlas_Tint(Drawer2D_Cols['f'], layer);
+	scale = 1.0f / glyph_size;
+
+	for (i = 0; i < text.length; i++) {
+		c = text.buffer[i];
+		if (c == '&' && Drawer2D_ValidColCodeAt(&text, i + 1)) {
+			tint = GlyphAtlas_Tint(Drawer2D_GetCol(text.buffer[i + 1]), layer);
+			i++; continue; /* skip over the colour code */
+		}
+
+		if (!(g = GlyphAtlas_Get(font, c, layer))) {
+			/* atlas is full, so start again with an empty atlas */
+			Drawer2D_FlushGlyphs();
+			GlyphAtlas_Reset();
+			font = GlyphAtlas_FindFont(&args->font);
+			if (!(g = GlyphAtlas_Get(font, c, layer))) return;
+		}
+
+		if (g->Width) {
+			if (glyph_quads == GLYPH_MAX_QUADS) Drawer2D_FlushGlyphs();
+			tex.X = x + g->OffsetX; tex.Width  = g->Width;
+			tex.Y = y + g->OffsetY; tex.Height = g->Height;
+
+			tex.uv.U1 = g->X * scale; tex.uv.U2 = (g->X + g->Width)  * scale;
+			tex.uv.V1 = g->Y * scale; tex.uv.V2 = (g->Y + g->Height) * scale;
+
+			ptr = &glyph_vertices[glyph_quads * 4];
+			Gfx_Make2DQuad(&tex, tint, &ptr);
+			glyph_quads++;
+		}
+		x += g->Advance;
+	}
+}
+
+void Drawer2D_DrawGlyphText(struct DrawTextArgs* args, int x, int y) {
+	Bitmap bmp;
+	if (Drawer2D_IsEmptyText(&args->text) || Gfx.LostContext) return;
+
+	if (!glyph_tex) {
+		glyph_size = min(GLYPH_ATLAS_SIZE, Gfx.MaxTexWidth);
+		glyph_size = min(glyph_size, Gfx.MaxTexHeight);
+
+		Bitmap_AllocateClearedPow2(&bmp, glyph_size, glyph_size);
+		glyph_tex = Gfx_CreateTexture(&bmp, true, false);
+		Mem_Free(bmp.Scan0);
+		GlyphAtlas_Reset();
+	}
+
+	/* all shadows are drawn first, same as with bitmapped text */
+	if (args->useShadow) GlyphAtlas_DrawLayer(args, x, y, GLYPH_LAYER_SHADOW);
+	GlyphAtlas_DrawLayer(args, x, y, GLYPH_LAYER_MAIN);
+}
+
+void Drawer2D_FlushGlyphs(void) {
+	if (!glyph_quads) return;
+	if (!glyph_vb) glyph_vb = Gfx_CreateDynamicVb(VERTEX_FORMAT_P3FT2FC4B, GLYPH_MAX_QUADS * 4);
+
+	Gfx_BindTexture(glyph_tex);
+	Gfx_SetVertexFormat(VERTEX_FORMAT_P3FT2FC4B);
+	Gfx_UpdateDynamicVb_IndexedTris(glyph_vb, glyph_vertices, glyph_quads * 4);
+	glyph_quads = 0;
+}
+
+static void GlyphAtlas_FontChanged(void* obj) { GlyphAtlas_Reset(); }
+
+static void GlyphAtlas_ContextLost(void* obj) {
+	/* texture and vertex buffer are lazily recreated when next needed */
+	Gfx_DeleteTexture(&glyph_tex);
+	Gfx_DeleteVb(&glyph_vb);
+	glyph_quads = 0;
+}
+
+
 /*########################################################################################################################*
 *---------------------------------------------------Drawer2D component----------------------------------------------------*
 *#########################################################################################################################*/
@@ -698,11 +940,16 @@ static void Drawer2D_Init(void) {
 
 	Drawer2D_CheckFont();
 	Event_RegisterEntry(&TextureEvents.FileChanged, NULL, Drawer2D_TextureChanged);
+	Event_RegisterVoid(&ChatEvents.FontChanged,     NULL, GlyphAtlas_FontChanged);
+	Event_RegisterVoid(&GfxEvents.ContextLost,      NULL, GlyphAtlas_ContextLost);
 }
 
 static void Drawer2D_Free(void) { 
 	Drawer2D_FreeFontBitmap();
+	GlyphAtlas_ContextLost(NULL);
 	Event_UnregisterEntry(&TextureEvents.FileChanged, NULL, Drawer2D_TextureChanged);
+	Event_UnregisterVoid(&ChatEvents.FontChanged,     NULL, GlyphAtlas_FontChanged);
+	Event_UnregisterVoid(&GfxEvents.ContextLost,      NULL, GlyphAtlas_ContextLost);
 }
 
 struct IGameComponent Drawer2D_Component = {
@@ -76,6 +76,12 @@ void Drawer2D_DrawClippedText(Bitmap* bmp, struct DrawTextArgs* args, int x, int
 /* Returns the line height for drawing any character in the font. */
 int Drawer2D_FontHeight(const FontDesc* font, bool useShadow);
 
+/* Queues the given text to be drawn at the given coordinates, using glyphs cached in a shared atlas texture. */
+/* NOTE: Text is only actually drawn after Drawer2D_FlushGlyphs is called. */
+void Drawer2D_DrawGlyphText(struct DrawTextArgs* args, int x, int y);
+/* Draws all text queued by Drawer2D_DrawGlyphText in one batch. */
+void Drawer2D_FlushGlyphs(void);
+
 /* Creates a texture consisting only of the given text drawn onto it. */
 /* NOTE: The returned texture is always padded up to nearest power of two dimensions. */
 CC_API void Drawer2D_MakeTextTexture(struct Texture* tex, struct DrawTextArgs* args, int X, int Y);
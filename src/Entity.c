@@ -19,6 +19,7 @@
 #include "Stream.h"
 #include "Bitmap.h"
 #include "Logger.h"
+#include "TexturePack.h"
 
 const char* NameMode_Names[NAME_MODE_COUNT]   = { "None", "Hovered", "All", "AllHovered", "AllUnscaled" };
 const char* ShadowMode_Names[SHADOW_MODE_COUNT] = { "None", "SnapToBlock", "Circle", "CircleAll" };
@@ -71,6 +72,8 @@ void Entity_Init(struct Entity* e) {
 	e->ModelScale = Vec3_Create1(1.0f);
 	e->uScale   = 1.0f;
 	e->vScale   = 1.0f;
+	e->uOffset  = 0.0f;
+	e->vOffset  = 0.0f;
 	e->StepSize = 0.5f;
 	e->SkinNameRaw[0]    = '\0';
 	e->DisplayNameRaw[0] = '\0';
@@ -227,6 +230,106 @@ bool Entity_TouchesAnyWater(struct Entity* e) {
 #define NAME_IS_EMPTY -30000
 #define NAME_OFFSET 3 /* offset of back layer of name above an entity */
 
+/* Nametags are packed into rows of a shared atlas texture, so they can all be drawn in one batch */
+#define NAMEATLAS_SIZE 1024
+#define NAMES_MAX_BATCH 256
+static GfxResourceID nameAtlas_tex, names_vb;
+static int nameAtlas_curX, nameAtlas_curY, nameAtlas_rowHeight;
+/* Area of the atlas used by names that are still in use */
+static int nameAtlas_liveArea;
+static VertexP3fT2fC4b names_vertices[NAMES_MAX_BATCH * 4];
+static int names_count;
+
+/* Draws all nametags queued in the batch */
+static void Entities_FlushNames(void) {
+	if (!names_count) return;
+	if (!names_vb) names_vb = Gfx_CreateDynamicVb(VERTEX_FORMAT_P3FT2FC4B, NAMES_MAX_BATCH * 4);
+
+	Gfx_BindTexture(nameAtlas_tex);
+	Gfx_SetVertexFormat(VERTEX_FORMAT_P3FT2FC4B);
+	Gfx_UpdateDynamicVb_IndexedTris(names_vb, names_vertices, names_count * 4);
+	names_count = 0;
+}
+
+/* Deletes the texture containing the entity's nametag */
+CC_NOINLINE static void Entity_DeleteNameTex(struct Entity* e) {
+	/* names in the atlas are just forgotten, their space is reclaimed when the atlas fills up */
+	if (e->NameTex.ID && e->NameTex.ID == nameAtlas_tex) {
+		e->NameTex.ID = GFX_NULL;
+		nameAtlas_liveArea -= e->NameTex.Width * e->NameTex.Height;
+	} else {
+		Gfx_DeleteTexture(&e->NameTex.ID);
+	}
+	e->NameTex.X = 0; /* X is used as an 'empty name' flag */
+}
+
+/* Forgets all names in the atlas, so they are redrawn into it when next rendered */
+static void NameAtlas_Reset(void) {
+	int i;
+	Entities_FlushNames();
+
+	for (i = 0; i < ENTITIES_MAX_COUNT; i++) {
+		if (!Entities.List[i] || !Entities.List[i]->NameTex.ID) continue;
+		if (Entities.List[i]->NameTex.ID == nameAtlas_tex) Entity_DeleteNameTex(Entities.List[i]);
+	}
+	nameAtlas_curX = 0; nameAtlas_curY = 0; nameAtlas_rowHeight = 0;
+	nameAtlas_liveArea = 0;
+}
+
+/* Attempts to upload the used area of the given nametag bitmap into the name atlas */
+static bool NameAtlas_Add(struct Entity* e, Bitmap* bmp, Size2D size) {
+	Bitmap part;
+	int y;
+
+	if (size.Width > NAMEATLAS_SIZE || size.Height > NAMEATLAS_SIZE) return false;
+	if (Gfx.MaxTexWidth < NAMEATLAS_SIZE || Gfx.MaxTexHeight < NAMEATLAS_SIZE) return false;
+
+	if (nameAtlas_curX + size.Width > NAMEATLAS_SIZE) {
+		nameAtlas_curX = 0; nameAtlas_curY += nameAtlas_rowHeight; nameAtlas_rowHeight = 0;
+	}
+
+	if (nameAtlas_curY + size.Height > NAMEATLAS_SIZE) {
+		/* Only start over when the atlas is mostly full of stale names. Otherwise the names in use */
+		/* would just fill it up again, and it would end up being rebuilt every frame. */
+		if (nameAtlas_liveArea > NAMEATLAS_SIZE * NAMEATLAS_SIZE / 4) return false;
+		NameAtlas_Reset();
+	}
+
+	if (!nameAtlas_tex) {
+		Bitmap_AllocateClearedPow2(&part, NAMEATLAS_SIZE, NAMEATLAS_SIZE);
+		nameAtlas_tex = Gfx_CreateTexture(&part, true, false);
+		Mem_Free(part.Scan0);
+	}
+
+	Bitmap_Allocate(&part, size.Width, size.Height);
+	for (y = 0; y < size.Height; y++) {
+		Mem_Copy(Bitmap_GetRow(&part, y), Bitmap_GetRow(bmp, y), size.Width * 4);
+	}
+	Gfx_UpdateTexturePart(nameAtlas_tex, nameAtlas_curX, nameAtlas_curY, &part, false);
+	Mem_Free(part.Scan0);
+
+	e->NameTex.ID    = nameAtlas_tex;
+	e->NameTex.Width = size.Width; e->NameTex.Height = size.Height;
+	nameAtlas_liveArea += size.Width * size.Height;
+	e->NameTex.uv.U1 = (float)nameAtlas_curX / NAMEATLAS_SIZE;
+	e->NameTex.uv.V1 = (float)nameAtlas_curY / NAMEATLAS_SIZE;
+	e->NameTex.uv.U2 = (float)(nameAtlas_curX + size.Width)  / NAMEATLAS_SIZE;
+	e->NameTex.uv.V2 = (float)(nameAtlas_curY + size.Height) / NAMEATLAS_SIZE;
+
+	/* leave a 1 pixel gap between names */
+	nameAtlas_curX     += size.Width + 1;
+	nameAtlas_rowHeight = max(nameAtlas_rowHeight, size.Height + 1);
+	return true;
+}
+
+static void NameAtlas_ContextLost(void) {
+	Gfx_DeleteTexture(&nameAtlas_tex);
+	Gfx_DeleteVb(&names_vb);
+	nameAtlas_curX = 0; nameAtlas_curY = 0; nameAtlas_rowHeight = 0;
+	nameAtlas_liveArea = 0;
+	names_count = 0;
+}
+
 static void Entity_MakeNameTexture(struct Entity* e) {
 	String colorlessName; char colorlessBuffer[STRING_SIZE];
 	BitmapCol shadowCol = BITMAPCOL_CONST(80, 80, 80, 255);
@@ -267,7 +370,11 @@ static void Entity_MakeNameTexture(struct Entity* e) {
 			args.text = name;
 			Drawer2D_DrawText(&bmp, &args, 0, 0);
 		}
-		Drawer2D_Make2DTexture(&e->NameTex, &bmp, size, 0, 0);
+
+		/* names too wide for the atlas, or that don't fit in a full atlas, get a texture to themselves */
+		if (!NameAtlas_Add(e, &bmp, size)) {
+			Drawer2D_Make2DTexture(&e->NameTex, &bmp, size, 0, 0);
+		}
 		Mem_Free(bmp.Scan0);
 	}
 	Drawer2D_BitmappedText = bitmapped;
@@ -285,7 +392,7 @@ static void Entity_DrawName(struct Entity* e) {
 
 	if (e->NameTex.X == NAME_IS_EMPTY) return;
 	if (!e->NameTex.ID) Entity_MakeNameTexture(e);
-	Gfx_BindTexture(e->NameTex.ID);
+	if (!e->NameTex.ID) return;
 
 	model = e->Model;
 	Vec3_TransformY(&pos, model->GetNameY(e), &e->Transform);
@@ -301,17 +408,23 @@ static void Entity_DrawName(struct Entity* e) {
 		size.X *= scale * 0.2f; size.Y *= scale * 0.2f;
 	}
 
+	/* billboard is centred size.Y / 2 above the name position */
+	if (!FrustumCulling_SphereInFrustum(pos.X, pos.Y + size.Y * 0.5f, pos.Z, max(size.X, size.Y))) return;
+	Entities.NamesDrawn++;
+
+	if (e->NameTex.ID == nameAtlas_tex) {
+		if (names_count == NAMES_MAX_BATCH) Entities_FlushNames();
+		Particle_DoRender(&size, &pos, &e->NameTex.uv, col, &names_vertices[names_count * 4]);
+		names_count++;
+		return;
+	}
+
+	Gfx_BindTexture(e->NameTex.ID);
 	Particle_DoRender(&size, &pos, &e->NameTex.uv, col, vertices);
 	Gfx_SetVertexFormat(VERTEX_FORMAT_P3FT2FC4B);
 	Gfx_UpdateDynamicVb_IndexedTris(Gfx_texVb, vertices, 4);
 }
 
-/* Deletes the texture containing the entity's nametag */
-CC_NOINLINE static void Entity_DeleteNameTex(struct Entity* e) {
-	Gfx_DeleteTexture(&e->NameTex.ID);
-	e->NameTex.X = 0; /* X is used as an 'empty name' flag */
-}
-
 void Entity_SetName(struct Entity* e, const String* name) {
 	Entity_DeleteNameTex(e);
 	String_CopyToRawArray(e->DisplayNameRaw, name);
@@ -345,6 +458,8 @@ static void Entity_CopySkin(struct Entity* dst, struct Entity* src) {
 	dst->SkinType  = src->SkinType;
 	dst->uScale    = src->uScale;
 	dst->vScale    = src->vScale;
+	dst->uOffset   = src->uOffset;
+	dst->vOffset   = src->vOffset;
 
 	/* Custom mob textures */
 	dst->MobTextureId = GFX_NULL;
@@ -354,7 +469,8 @@ static void Entity_CopySkin(struct Entity* dst, struct Entity* src) {
 
 /* Resets skin data for the given entity */
 static void Entity_ResetSkin(struct Entity* e) {
-	e->uScale = 1.0f; e->vScale = 1.0f;
+	e->uScale  = 1.0f; e->vScale  = 1.0f;
+	e->uOffset = 0.0f; e->vOffset = 0.0f;
 	e->MobTextureId = GFX_NULL;
 	e->TextureId    = GFX_NULL;
 	e->SkinType     = SKIN_64x32;
@@ -383,6 +499,22 @@ static void Entity_SetSkinAll(struct Entity* source, bool reset) {
 	}
 }
 
+/* Marks all entities with same skin as still waiting on the skin's download request */
+static void Entity_SetSkinDownloadingAll(struct Entity* source) {
+	struct Entity* e;
+	String skin, eSkin;
+	int i;
+
+	skin = String_FromRawArray(source->SkinNameRaw);
+	for (i = 0; i < ENTITIES_MAX_COUNT; i++) {
+		if (!Entities.List[i]) continue;
+
+		e     = Entities.List[i];
+		eSkin = String_FromRawArray(e->SkinNameRaw);
+		if (String_Equals(&skin, &eSkin)) e->SkinFetchState = SKIN_FETCH_DOWNLOADING;
+	}
+}
+
 /* Clears hat area from a skin bitmap if it's completely white or black,
    so skins edited with Microsoft Paint or similiar don't have a solid hat */
 static void Entity_ClearHat(Bitmap* bmp, uint8_t skinType) {
@@ -437,14 +569,124 @@ static void Entity_EnsurePow2(struct Entity* e, Bitmap* bmp) {
 	*bmp = scaled;
 }
 
+/* 64x32 and 64x64 skins are packed into a few shared atlas textures, divided into 64x64 slots */
+#define SKINATLAS_SIZE  512
+#define SKINATLAS_SLOTS (SKINATLAS_SIZE / 64)
+#define SKINATLAS_MAX_ATLASES 4
+static GfxResourceID skinAtlas_texs[SKINATLAS_MAX_ATLASES];
+/* Bit mask of which slots are used in each atlas */
+static uint64_t skinAtlas_used[SKINATLAS_MAX_ATLASES];
+
+/* Attempts to upload the given skin into a free slot of a skin atlas */
+static bool SkinAtlas_Add(struct Entity* e, Bitmap* bmp) {
+	Bitmap atlas;
+	int i, slot, x, y;
+
+	if (bmp->Width != 64 || (bmp->Height != 32 && bmp->Height != 64)) return false;
+	if (Gfx.MaxTexWidth < SKINATLAS_SIZE || Gfx.MaxTexHeight < SKINATLAS_SIZE) return false;
+
+	for (i = 0; i < SKINATLAS_MAX_ATLASES; i++) {
+		if (skinAtlas_used[i] == (uint64_t)-1) continue;
+		for (slot = 0; skinAtlas_used[i] & ((uint64_t)1 << slot); slot++) { }
+
+		if (!skinAtlas_texs[i]) {
+			Bitmap_AllocateClearedPow2(&atlas, SKINATLAS_SIZE, SKINATLAS_SIZE);
+			skinAtlas_texs[i] = Gfx_CreateTexture(&atlas, true, false);
+			Mem_Free(atlas.Scan0);
+		}
+
+		x = (slot % SKINATLAS_SLOTS) * 64;
+		y = (slot / SKINATLAS_SLOTS) * 64;
+		Gfx_UpdateTexturePart(skinAtlas_texs[i], x, y, bmp, false);
+		skinAtlas_used[i] |= (uint64_t)1 << slot;
+
+		e->TextureId = skinAtlas_texs[i];
+		e->uOffset   = (float)x / SKINATLAS_SIZE;
+		e->vOffset   = (float)y / SKINATLAS_SIZE;
+		e->uScale    = (float)bmp->Width  / SKINATLAS_SIZE;
+		e->vScale    = (float)bmp->Height / SKINATLAS_SIZE;
+		return true;
+	}
+	return false;
+}
+
+/* Frees the atlas slot used by the given entity's skin, if it is in a skin atlas */
+static bool SkinAtlas_Remove(struct Entity* e) {
+	int i, slot;
+	for (i = 0; i < SKINATLAS_MAX_ATLASES; i++) {
+		if (!skinAtlas_texs[i] || skinAtlas_texs[i] != e->TextureId) continue;
+
+		slot = (int)(e->vOffset * SKINATLAS_SLOTS + 0.5f) * SKINATLAS_SLOTS
+			 + (int)(e->uOffset * SKINATLAS_SLOTS + 0.5f);
+		skinAtlas_used[i] &= ~((uint64_t)1 << slot);
+
+		if (!skinAtlas_used[i]) Gfx_DeleteTexture(&skinAtlas_texs[i]);
+		e->TextureId = GFX_NULL;
+		return true;
+	}
+	return false;
+}
+
+/* Deletes the entity's skin texture, or frees its slot if the skin is in a skin atlas */
+static void Entity_FreeSkinTexture(struct Entity* e) {
+	if (!e->TextureId) return;
+	if (!SkinAtlas_Remove(e)) Gfx_DeleteTexture(&e->TextureId);
+}
+
+/* Decodes a skin, then uploads it to the GPU and applies it to all entities with the same skin */
+static void Entity_LoadSkin(struct Entity* e, struct Stream* src, const String* url) {
+	String skin = String_FromRawArray(e->SkinNameRaw);
+	Bitmap bmp;
+	ReturnCode res;
+
+	if ((res = Png_Decode(&bmp, src))) {
+		Logger_Warn2(res, "decoding", url);
+		Mem_Free(bmp.Scan0); return;
+	}
+
+	Entity_FreeSkinTexture(e);
+	Entity_SetSkinAll(e, true);
+	Entity_EnsurePow2(e, &bmp);
+	e->SkinType = Utils_CalcSkinType(&bmp);
+
+	if (bmp.Width > Gfx.MaxTexWidth || bmp.Height > Gfx.MaxTexHeight) {
+		Chat_Add1("&cSkin %s is too large", &skin);
+	} else if (e->SkinType != SKIN_INVALID) {
+		if (e->Model->UsesHumanSkin) Entity_ClearHat(&bmp, e->SkinType);
+		if (!SkinAtlas_Add(e, &bmp)) {
+			e->TextureId = Gfx_CreateTexture(&bmp, true, false);
+		}
+		Entity_SetSkinAll(e, false);
+	}
+	Mem_Free(bmp.Scan0);
+}
+
+/* Loads the skin from the texture cache if present, then asynchronously revalidates/downloads it */
+static void Entity_DownloadSkin(struct Entity* e, const String* skin) {
+	String url; char urlBuffer[STRING_SIZE];
+	struct Stream stream, buffered;
+	uint8_t buffer[8192];
+	ReturnCode res;
+
+	String_InitArray(url, urlBuffer);
+	Http_MakeSkinUrl(&url, skin);
+
+	if (TextureCache_Get(&url, &stream)) {
+		Stream_ReadonlyBuffered(&buffered, &stream, buffer, sizeof(buffer));
+		Entity_LoadSkin(e, &buffered, &url);
+		if ((res = stream.Close(&stream))) { Logger_Warn2(res, "closing cache for", &url); }
+
+		/* Loading marks the skin as completed, but the revalidation request still needs to be checked */
+		Entity_SetSkinDownloadingAll(e);
+	}
+	TextureCache_DownloadAsync(&url, false, skin);
+}
+
 static void Entity_CheckSkin(struct Entity* e) {
 	struct Entity* first;
 	String url, skin;
-
 	struct HttpRequest item;
 	struct Stream mem;
-	Bitmap bmp;
-	ReturnCode res;
 
 	/* Don't check skin if don't have to */
 	if (!e->Model->UsesSkin) return;
@@ -454,7 +696,11 @@ static void Entity_CheckSkin(struct Entity* e) {
 	if (!e->SkinFetchState) {
 		first = Entity_FirstOtherWithSameSkinAndFetchedSkin(e);
 		if (!first) {
-			Http_AsyncGetSkin(&skin);
+			e->SkinFetchState = SKIN_FETCH_DOWNLOADING;
+			Entity_DownloadSkin(e, &skin);
+		} else if (first->SkinFetchState == SKIN_FETCH_DOWNLOADING) {
+			/* Skin is already being downloaded, so wait on that request instead */
+			Entity_CopySkin(e, first);
 			e->SkinFetchState = SKIN_FETCH_DOWNLOADING;
 		} else {
 			Entity_CopySkin(e, first);
@@ -464,45 +710,42 @@ static void Entity_CheckSkin(struct Entity* e) {
 	}
 
 	if (!Http_GetResult(&skin, &item)) return;
-	if (!item.Success) { Entity_SetSkinAll(e, true); return; }
-	Stream_ReadonlyMemory(&mem, item.Data, item.Size);
-
-	if ((res = Png_Decode(&bmp, &mem))) {
-		url = String_FromRawArray(item.URL);
-		Logger_Warn2(res, "decoding", &url);
-		Mem_Free(bmp.Scan0); return;
+	if (!item.Success) {
+		/* 304 Not Modified (or server unreachable), so keep using skin loaded from the cache */
+		Entity_SetSkinAll(e, !e->TextureId); return;
 	}
 
-	Gfx_DeleteTexture(&e->TextureId);
-	Entity_SetSkinAll(e, true);
-	Entity_EnsurePow2(e, &bmp);
-	e->SkinType = Utils_CalcSkinType(&bmp);
+	url = String_FromRawArray(item.URL);
+	TextureCache_Update(&item);
+	Stream_ReadonlyMemory(&mem, item.Data, item.Size);
 
-	if (bmp.Width > Gfx.MaxTexWidth || bmp.Height > Gfx.MaxTexHeight) {
-		Chat_Add1("&cSkin %s is too large", &skin);
-	} else if (e->SkinType != SKIN_INVALID) {
-		if (e->Model->UsesHumanSkin) Entity_ClearHat(&bmp, e->SkinType);
-		e->TextureId = Gfx_CreateTexture(&bmp, true, false);
-		Entity_SetSkinAll(e, false);
-	}
-	Mem_Free(bmp.Scan0);
+	Entity_LoadSkin(e, &mem, &url);
+	HttpRequest_Free(&item);
+
+	/* New skin couldn't be decoded, so keep using skin loaded from the cache */
+	if (e->SkinFetchState != SKIN_FETCH_COMPLETED) Entity_SetSkinAll(e, !e->TextureId);
 }
 
 /* Returns true if no other entities are sharing this skin texture */
 static bool Entity_CanDeleteTexture(struct Entity* except) {
+	struct Entity* e;
 	int i;
 	if (!except->TextureId) return false;
 
 	for (i = 0; i < ENTITIES_MAX_COUNT; i++) {
-		if (!Entities.List[i] || Entities.List[i] == except)  continue;
-		if (Entities.List[i]->TextureId == except->TextureId) return false;
+		if (!Entities.List[i] || Entities.List[i] == except) continue;
+		e = Entities.List[i];
+
+		/* skins in the same atlas share a texture, but are at different offsets */
+		if (e->TextureId == except->TextureId && e->uOffset == except->uOffset
+			&& e->vOffset == except->vOffset) return false;
 	}
 	return true;
 }
 
 CC_NOINLINE static void Entity_DeleteSkin(struct Entity* e) {
 	if (Entity_CanDeleteTexture(e)) {
-		Gfx_DeleteTexture(&e->TextureId);
+		Entity_FreeSkinTexture(e);
 	}
 
 	Entity_ResetSkin(e);
@@ -515,6 +758,153 @@ void Entity_SetSkin(struct Entity* e, const String* skin) {
 }
 
 
+/*########################################################################################################################*
+*------------------------------------------------------Entities grid------------------------------------------------------*
+*#########################################################################################################################*/
+/* Entities are bucketed into a uniform grid of cells on the XZ plane, */
+/*  so that spatial queries only need to check entities in nearby cells */
+#define GRID_CELL_SHIFT 3 /* cells are 8x8 blocks */
+#define GRID_CELL_SIZE (1 << GRID_CELL_SHIFT)
+#define GRID_BUCKETS 512
+/* Entities covering more cells than this (e.g. huge model scale) are checked by every query */
+#define GRID_MAX_CELLS 4
+
+static uint16_t grid_bucketStart[GRID_BUCKETS + 1];
+static EntityID grid_entries[ENTITIES_MAX_COUNT * GRID_MAX_CELLS];
+static EntityID grid_large[ENTITIES_MAX_COUNT];
+static int grid_entriesCount, grid_largeCount;
+/* Bounds of the cells that contain at least one entity */
+static int grid_minX, grid_minZ, grid_maxX, grid_maxZ;
+
+static int EntitiesGrid_Bucket(int cellX, int cellZ) {
+	/* Unsigned, since signed multiplication overflowing is undefined behaviour */
+	return (int)(((uint32_t)cellX * 73856093u ^ (uint32_t)cellZ * 19349663u) & (GRID_BUCKETS - 1));
+}
+
+/* Calculates range of cells that may contain any part of the given entity */
+static void EntitiesGrid_GetCells(struct Entity* e, int* minX, int* minZ, int* maxX, int* maxZ) {
+	struct AABB* bb = &e->ModelAABB;
+	float x = max(Math_AbsF(bb->Min.X), Math_AbsF(bb->Max.X));
+	float y = max(Math_AbsF(bb->Min.Y), Math_AbsF(bb->Max.Y));
+	float z = max(Math_AbsF(bb->Min.Z), Math_AbsF(bb->Max.Z));
+
+	/* picking bounds can be rotated in any direction around the entity's position */
+	float radius = Math_SqrtF(x * x + y * y + z * z);
+	radius = max(radius, e->Size.X * 0.5f);
+	radius = max(radius, e->Size.Z * 0.5f);
+
+	*minX = Math_Floor(e->Position.X - radius) >> GRID_CELL_SHIFT;
+	*minZ = Math_Floor(e->Position.Z - radius) >> GRID_CELL_SHIFT;
+	*maxX = Math_Floor(e->Position.X + radius) >> GRID_CELL_SHIFT;
+	*maxZ = Math_Floor(e->Position.Z + radius) >> GRID_CELL_SHIFT;
+}
+
+static void EntitiesGrid_InitAxis(float origin, float dir, int cell, int* step, float* tMax, float* tDelta) {
+	if (dir > 0.0f) {
+		*step = 1;  *tMax = ((cell + 1) * GRID_CELL_SIZE - origin) / dir; *tDelta =  GRID_CELL_SIZE / dir;
+	} else if (dir < 0.0f) {
+		*step = -1; *tMax = (cell * GRID_CELL_SIZE - origin) / dir;       *tDelta = -GRID_CELL_SIZE / dir;
+	} else {
+		*step = 0;  *tMax = MATH_POS_INF; *tDelta = MATH_POS_INF;
+	}
+}
+
+void EntitiesGrid_Update(void) {
+	static int cells[ENTITIES_MAX_COUNT][4];
+	uint16_t next[GRID_BUCKETS];
+	struct Entity* e;
+	int i, x, z, bucket, count;
+
+	Mem_Set(grid_bucketStart, 0, sizeof(grid_bucketStart));
+	grid_entriesCount = 0; grid_largeCount = 0;
+	grid_minX = Int32_MaxValue; grid_maxX = Int32_MinValue;
+	grid_minZ = Int32_MaxValue; grid_maxZ = Int32_MinValue;
+
+	/* count how many entries each bucket has */
+	for (i = 0; i < ENTITIES_MAX_COUNT; i++) {
+		e = Entities.List[i];
+		cells[i][0] = 0; cells[i][2] = -1;
+		if (!e) continue;
+
+		EntitiesGrid_GetCells(e, &cells[i][0], &cells[i][1], &cells[i][2], &cells[i][3]);
+		count = (cells[i][2] - cells[i][0] + 1) * (cells[i][3] - cells[i][1] + 1);
+
+		if (count > GRID_MAX_CELLS || count <= 0) {
+			grid_large[grid_largeCount++] = (EntityID)i;
+			cells[i][0] = 0; cells[i][2] = -1; continue;
+		}
+
+		for (z = cells[i][1]; z <= cells[i][3]; z++) {
+			for (x = cells[i][0]; x <= cells[i][2]; x++) {
+				grid_bucketStart[EntitiesGrid_Bucket(x, z) + 1]++;
+			}
+		}
+		grid_minX = min(grid_minX, cells[i][0]); grid_maxX = max(grid_maxX, cells[i][2]);
+		grid_minZ = min(grid_minZ, cells[i][1]); grid_maxZ = max(grid_maxZ, cells[i][3]);
+	}
+
+	for (i = 0; i < GRID_BUCKETS; i++) {
+		grid_bucketStart[i + 1] += grid_bucketStart[i];
+		next[i] = grid_bucketStart[i];
+	}
+
+	/* then fill in buckets, with IDs in ascending order within each bucket */
+	for (i = 0; i < ENTITIES_MAX_COUNT; i++) {
+		for (z = cells[i][1]; z <= cells[i][3]; z++) {
+			for (x = cells[i][0]; x <= cells[i][2]; x++) {
+				bucket = EntitiesGrid_Bucket(x, z);
+				grid_entries[next[bucket]++] = (EntityID)i;
+			}
+		}
+	}
+	grid_entriesCount = grid_bucketStart[GRID_BUCKETS];
+}
+
+int Entities_QueryArea(float minX, float minZ, float maxX, float maxZ, EntityID* ids) {
+	static uint8_t seen[ENTITIES_MAX_COUNT];
+	int x1, z1, x2, z2, x, z;
+	int i, j, bucket, count = 0;
+	EntityID id;
+
+	for (i = 0; i < grid_largeCount; i++) {
+		id = grid_large[i];
+		seen[id] = true; ids[count++] = id;
+	}
+
+	x1 = max(Math_Floor(minX) >> GRID_CELL_SHIFT, grid_minX);
+	z1 = max(Math_Floor(minZ) >> GRID_CELL_SHIFT, grid_minZ);
+	x2 = min(Math_Floor(maxX) >> GRID_CELL_SHIFT, grid_maxX);
+	z2 = min(Math_Floor(maxZ) >> GRID_CELL_SHIFT, grid_maxZ);
+
+	for (z = z1; z <= z2; z++) {
+		for (x = x1; x <= x2; x++) {
+			bucket = EntitiesGrid_Bucket(x, z);
+
+			for (j = grid_bucketStart[bucket]; j < grid_bucketStart[bucket + 1]; j++) {
+				id = grid_entries[j];
+				if (seen[id]) continue;
+				seen[id] = true; ids[count++] = id;
+			}
+		}
+	}
+
+	/* sort IDs (insertion sort, count is usually tiny), so results are */
+	/*  processed in the same order as iterating over Entities.List would */
+	for (i = 1; i < count; i++) {
+		id = ids[i];
+		for (j = i - 1; j >= 0 && ids[j] > id; j--) { ids[j + 1] = ids[j]; }
+		ids[j + 1] = id;
+	}
+
+	/* reset seen flags, and also skip entities removed since grid was updated */
+	for (i = 0, j = 0; i < count; i++) {
+		id = ids[i]; seen[id] = false;
+		if (Entities.List[id]) ids[j++] = id;
+	}
+	return j;
+}
+
+
 /*########################################################################################################################*
 *--------------------------------------------------------Entities---------------------------------------------------------*
 *#########################################################################################################################*/
@@ -523,23 +913,54 @@ static EntityID entities_closestId;
 
 void Entities_Tick(struct ScheduledTask* task) {
 	int i;
+	EntitiesGrid_Update();
+
 	for (i = 0; i < ENTITIES_MAX_COUNT; i++) {
 		if (!Entities.List[i]) continue;
 		Entities.List[i]->VTABLE->Tick(Entities.List[i], task->Interval);
 	}
+	/* interpolation states of network players have been advanced */
+	NetPlayers_MarkChanged();
+}
+
+/* Texture the entity's model is drawn with. (see Model_ApplyTexture) */
+#define Entity_ModelTex(e) ((e)->Model->UsesHumanSkin ? (e)->TextureId : (e)->MobTextureId)
+
+/* Whether entity a should be rendered before entity b, so that models with the same */
+/* model and texture are rendered consecutively and so can be drawn in one batch. */
+static bool Entities_RenderBefore(struct Entity* a, struct Entity* b) {
+	if (a->Model != b->Model) return (uintptr_t)a->Model < (uintptr_t)b->Model;
+	return (uintptr_t)Entity_ModelTex(a) < (uintptr_t)Entity_ModelTex(b);
 }
 
 void Entities_RenderModels(double delta, float t) {
-	int i;
+	struct Entity* order[ENTITIES_MAX_COUNT];
+	struct Entity* e;
+	int i, j, count = 0;
+
 	Gfx_SetTexturing(true);
 	Gfx_SetAlphaTest(true);
-	
+	NetPlayers_Interpolate(t);
+
+	/* insertion sort is fast enough for at most ENTITIES_MAX_COUNT entities */
 	for (i = 0; i < ENTITIES_MAX_COUNT; i++) {
-		if (!Entities.List[i]) continue;
-		Entities.List[i]->VTABLE->RenderModel(Entities.List[i], delta, t);
+		if (!(e = Entities.List[i])) continue;
+
+		for (j = count; j > 0 && Entities_RenderBefore(e, order[j - 1]); j--) {
+			order[j] = order[j - 1];
+		}
+		order[j] = e; count++;
+	}
+
+	Model_BeginBatch();
+	for (i = 0; i < count; i++) {
+		order[i]->VTABLE->RenderModel(order[i], delta, t);
 	}
+	Model_EndBatch();
 	Gfx_SetTexturing(false);
 	Gfx_SetAlphaTest(false);
+	/* entity positions were just interpolated for rendering */
+	EntitiesGrid_Update();
 }
 	
 
@@ -548,6 +969,7 @@ void Entities_RenderNames(double delta) {
 	bool hadFog;
 	int i;
 
+	Entities.NamesDrawn = 0;
 	if (Entities.NamesMode == NAME_MODE_NONE) return;
 	entities_closestId = Entities_GetCloset(&p->Base);
 	if (!p->Hacks.CanSeeAllNames || Entities.NamesMode != NAME_MODE_ALL) return;
@@ -563,6 +985,7 @@ void Entities_RenderNames(double delta) {
 			Entities.List[i]->VTABLE->RenderName(Entities.List[i]);
 		}
 	}
+	Entities_FlushNames();
 
 	Gfx_SetTexturing(false);
 	Gfx_SetAlphaTest(false);
@@ -590,6 +1013,7 @@ void Entities_RenderHoveredNames(double delta) {
 			Entities.List[i]->VTABLE->RenderName(Entities.List[i]);
 		}
 	}
+	Entities_FlushNames();
 
 	Gfx_SetTexturing(false);
 	Gfx_SetAlphaTest(false);
@@ -607,6 +1031,7 @@ static void Entities_ContextLost(void* obj) {
 		if (!Entities.List[i]) continue;
 		Entity_ContextLost(Entities.List[i]);
 	}
+	NameAtlas_ContextLost();
 	Gfx_DeleteTexture(&ShadowComponent_ShadowTex);
 }
 
@@ -631,6 +1056,21 @@ void Entities_Remove(EntityID id) {
 	Event_RaiseInt(&EntityEvents.Removed, id);
 	Entities.List[id]->VTABLE->Despawn(Entities.List[id]);
 	Entities.List[id] = NULL;
+	NetPlayers_MarkChanged();
+}
+
+static void Entities_CheckCloset(EntityID id, Vec3 eyePos, Vec3 dir, float* closestDist, EntityID* targetId) {
+	struct Entity* entity = Entities.List[id];
+	float t0, t1;
+	/* because we don't want to pick against local player */
+	if (!entity || id == ENTITIES_SELF_ID) return;
+
+	if (!Intersection_RayIntersectsRotatedBox(eyePos, dir, entity, &t0, &t1)) return;
+	/* ties go to lowest ID, regardless of the order cells are visited in */
+	if (t0 < *closestDist || (t0 == *closestDist && id < *targetId)) {
+		*closestDist = t0;
+		*targetId    = id;
+	}
 }
 
 EntityID Entities_GetCloset(struct Entity* src) {
@@ -639,16 +1079,43 @@ EntityID Entities_GetCloset(struct Entity* src) {
 	float closestDist = MATH_POS_INF;
 	EntityID targetId = ENTITIES_SELF_ID;
 
-	float t0, t1;
-	int i;
+	float tMaxX, tMaxZ, tDeltaX, tDeltaZ, tEnter = 0.0f;
+	int cellX, cellZ, stepX, stepZ;
+	int i, j, bucket;
+
+	for (i = 0; i < grid_largeCount; i++) {
+		Entities_CheckCloset(grid_large[i], eyePos, dir, &closestDist, &targetId);
+	}
+	if (!grid_entriesCount) return targetId;
+
+	/* Walk the cells the ray passes through on the XZ plane, nearest first */
+	cellX = Math_Floor(eyePos.X) >> GRID_CELL_SHIFT;
+	cellZ = Math_Floor(eyePos.Z) >> GRID_CELL_SHIFT;
+	EntitiesGrid_InitAxis(eyePos.X, dir.X, cellX, &stepX, &tMaxX, &tDeltaX);
+	EntitiesGrid_InitAxis(eyePos.Z, dir.Z, cellZ, &stepZ, &tMaxZ, &tDeltaZ);
+
+	for (;;) {
+		/* no entity in a later cell can be closer than the one already found */
+		if (tEnter > closestDist) break;
+
+		if (cellX >= grid_minX && cellX <= grid_maxX && cellZ >= grid_minZ && cellZ <= grid_maxZ) {
+			bucket = EntitiesGrid_Bucket(cellX, cellZ);
+			for (j = grid_bucketStart[bucket]; j < grid_bucketStart[bucket + 1]; j++) {
+				Entities_CheckCloset(grid_entries[j], eyePos, dir, &closestDist, &targetId);
+			}
+		}
 
-	for (i = 0; i < ENTITIES_SELF_ID; i++) { /* because we don't want to pick against local player */
-		struct Entity* entity = Entities.List[i];
-		if (!entity) continue;
+		/* stop once moving away from every occupied cell */
+		if (stepX >= 0 && cellX > grid_maxX) break;
+		if (stepX <= 0 && cellX < grid_minX) break;
+		if (stepZ >= 0 && cellZ > grid_maxZ) break;
+		if (stepZ <= 0 && cellZ < grid_minZ) break;
+		if (!stepX && !stepZ) break;
 
-		if (Intersection_RayIntersectsRotatedBox(eyePos, dir, entity, &t0, &t1) && t0 < closestDist) {
-			closestDist = t0;
-			targetId = (EntityID)i;
+		if (tMaxX < tMaxZ) {
+			tEnter = tMaxX; cellX += stepX; tMaxX += tDeltaX;
+		} else {
+			tEnter = tMaxZ; cellZ += stepZ; tMaxZ += tDeltaZ;
 		}
 	}
 	return targetId;
@@ -1059,11 +1526,126 @@ bool LocalPlayer_HandlesKey(Key key) {
 /*########################################################################################################################*
 *-------------------------------------------------------NetPlayer---------------------------------------------------------*
 *#########################################################################################################################*/
-struct NetPlayer NetPlayers_List[ENTITIES_SELF_ID];
+struct NetPlayer NetPlayers_List[ENTITIES_MAX_COUNT];
+
+/* Interpolation fields, stored in structure of arrays form */
+enum NETINTERP_FIELD {
+	NETINTERP_POS_X, NETINTERP_POS_Y, NETINTERP_POS_Z, /* linearly interpolated */
+	NETINTERP_HEAD_X, NETINTERP_HEAD_Y, NETINTERP_ROT_X, NETINTERP_ROT_Y, NETINTERP_ROT_Z, /* angles */
+	NETINTERP_FIELDS
+};
+#define NETINTERP_FIRST_ANGLE NETINTERP_HEAD_X
+
+/* Hot per-frame interpolation state of all network players, kept contiguously (instead of */
+/*  scattered across each NetPlayer), so interpolating all of them is a tight loop per field */
+static struct NetPlayersInterp {
+	int count;
+	bool dirty, valid;
+	float t;
+	struct NetPlayer* players[ENTITIES_MAX_COUNT];
+	/* Index into prev/next/cur arrays, or -1 if the player is not interpolated in batch */
+	int16_t slot[ENTITIES_MAX_COUNT];
+	float prev[NETINTERP_FIELDS][ENTITIES_MAX_COUNT];
+	float next[NETINTERP_FIELDS][ENTITIES_MAX_COUNT];
+	float cur[NETINTERP_FIELDS][ENTITIES_MAX_COUNT];
+} netInterp = { 0, true };
+
+static void NetPlayer_RenderModel(struct Entity* e, double deltaTime, float t);
+static void NetPlayers_Gather(void) {
+	struct InterpState* prev;
+	struct InterpState* next;
+	struct NetPlayer* p;
+	int i, j;
+
+	netInterp.count = 0;
+	netInterp.dirty = false;
+
+	for (i = 0; i < ENTITIES_MAX_COUNT; i++) {
+		p = (struct NetPlayer*)Entities.List[i];
+		netInterp.slot[i] = -1;
+		/* plugins may have replaced the vtable or use their own storage */
+		if (!p || p != &NetPlayers_List[i] || p->Base.VTABLE->RenderModel != NetPlayer_RenderModel) continue;
+
+		j = netInterp.count++;
+		netInterp.slot[i]    = j;
+		netInterp.players[j] = p;
+		prev = &p->Interp.Prev; next = &p->Interp.Next;
+
+		netInterp.prev[NETINTERP_POS_X][j]  = prev->Pos.X;  netInterp.next[NETINTERP_POS_X][j]  = next->Pos.X;
+		netInterp.prev[NETINTERP_POS_Y][j]  = prev->Pos.Y;  netInterp.next[NETINTERP_POS_Y][j]  = next->Pos.Y;
+		netInterp.prev[NETINTERP_POS_Z][j]  = prev->Pos.Z;  netInterp.next[NETINTERP_POS_Z][j]  = next->Pos.Z;
+		netInterp.prev[NETINTERP_HEAD_X][j] = prev->HeadX;  netInterp.next[NETINTERP_HEAD_X][j] = next->HeadX;
+		netInterp.prev[NETINTERP_HEAD_Y][j] = prev->HeadY;  netInterp.next[NETINTERP_HEAD_Y][j] = next->HeadY;
+		netInterp.prev[NETINTERP_ROT_X][j]  = prev->RotX;   netInterp.next[NETINTERP_ROT_X][j]  = next->RotX;
+		netInterp.prev[NETINTERP_ROT_Y][j]  = p->Interp.PrevRotY;
+		netInterp.next[NETINTERP_ROT_Y][j]  = p->Interp.NextRotY;
+		netInterp.prev[NETINTERP_ROT_Z][j]  = prev->RotZ;   netInterp.next[NETINTERP_ROT_Z][j]  = next->RotZ;
+	}
+}
+
+void NetPlayers_Interpolate(float t) {
+	float a, b, l, r;
+	int f, i, count;
+	if (netInterp.dirty) NetPlayers_Gather();
+	count = netInterp.count;
+
+	/* NOTE: Must produce exactly the same results as Vec3_Lerp and Math_LerpAngle */
+	for (f = 0; f < NETINTERP_FIRST_ANGLE; f++) {
+		float* prev = netInterp.prev[f];
+		float* next = netInterp.next[f];
+		float* cur  = netInterp.cur[f];
+
+		for (i = 0; i < count; i++) {
+			cur[i] = t * (next[i] - prev[i]) + prev[i];
+		}
+	}
+
+	for (f = NETINTERP_FIRST_ANGLE; f < NETINTERP_FIELDS; f++) {
+		float* prev = netInterp.prev[f];
+		float* next = netInterp.next[f];
+		float* cur  = netInterp.cur[f];
+
+		for (i = 0; i < count; i++) {
+			a = prev[i]; b = next[i];
+			/* Consider 350* --> 0*, we only want to travel 10* */
+			l = (a > 270.0f && b < 90.0f) ? a - 360.0f : a;
+			r = (b > 270.0f && a < 90.0f) ? b - 360.0f : b;
+			cur[i] = l + (r - l) * t;
+		}
+	}
+	netInterp.t     = t;
+	netInterp.valid = true;
+}
+
+/* Copies position and orientation calculated by NetPlayers_Interpolate to the given player */
+/* Returns false if the player wasn't interpolated in that batch */
+static bool NetPlayer_ApplyInterpolated(struct NetPlayer* p, float t) {
+	struct Entity* e = &p->Base;
+	int i, j;
+	if (!netInterp.valid || netInterp.dirty || netInterp.t != t) return false;
+
+	i = (int)(p - NetPlayers_List);
+	if (i < 0 || i >= ENTITIES_MAX_COUNT) return false;
+	j = netInterp.slot[i];
+	if (j == -1 || netInterp.players[j] != p) return false;
+
+	e->Position.X = netInterp.cur[NETINTERP_POS_X][j];
+	e->Position.Y = netInterp.cur[NETINTERP_POS_Y][j];
+	e->Position.Z = netInterp.cur[NETINTERP_POS_Z][j];
+	e->HeadX = netInterp.cur[NETINTERP_HEAD_X][j];
+	e->HeadY = netInterp.cur[NETINTERP_HEAD_Y][j];
+	e->RotX  = netInterp.cur[NETINTERP_ROT_X][j];
+	e->RotY  = netInterp.cur[NETINTERP_ROT_Y][j];
+	e->RotZ  = netInterp.cur[NETINTERP_ROT_Z][j];
+	return true;
+}
+
+void NetPlayers_MarkChanged(void) { netInterp.dirty = true; }
 
 static void NetPlayer_SetLocation(struct Entity* e, struct LocationUpdate* update, bool interpolate) {
 	struct NetPlayer* p = (struct NetPlayer*)e;
 	NetInterpComp_SetLocation(&p->Interp, update, interpolate);
+	netInterp.dirty = true;
 }
 
 static void NetPlayer_Tick(struct Entity* e, double delta) {
@@ -1075,8 +1657,11 @@ static void NetPlayer_Tick(struct Entity* e, double delta) {
 
 static void NetPlayer_RenderModel(struct Entity* e, double deltaTime, float t) {
 	struct NetPlayer* p = (struct NetPlayer*)e;
-	Vec3_Lerp(&e->Position, &p->Interp.Prev.Pos, &p->Interp.Next.Pos, t);
-	InterpComp_LerpAngles((struct InterpComp*)(&p->Interp), e, t);
+	/* usually already calculated for all players at once by NetPlayers_Interpolate */
+	if (!NetPlayer_ApplyInterpolated(p, t)) {
+		Vec3_Lerp(&e->Position, &p->Interp.Prev.Pos, &p->Interp.Next.Pos, t);
+		InterpComp_LerpAngles((struct InterpComp*)(&p->Interp), e, t);
+	}
 
 	AnimatedComp_GetCurrent(e, t);
 	p->ShouldRender = Model_ShouldRender(e);
@@ -1101,7 +1686,8 @@ struct EntityVTABLE netPlayer_VTABLE = {
 void NetPlayer_Init(struct NetPlayer* p) {
 	Mem_Set(p, 0, sizeof(struct NetPlayer));
 	Entity_Init(&p->Base);
-	p->Base.VTABLE = &netPlayer_VTABLE;
+	p->Base.VTABLE  = &netPlayer_VTABLE;
+	netInterp.dirty = true;
 }
 
 
@@ -1137,6 +1723,7 @@ static void Entities_Free(void) {
 	Event_UnregisterVoid(&GfxEvents.ContextRecreated, NULL, Entities_ContextRecreated);
 	Event_UnregisterVoid(&ChatEvents.FontChanged,     NULL, Entities_ChatFontChanged);
 
+	NameAtlas_ContextLost();
 	if (ShadowComponent_ShadowTex) {
 		Gfx_DeleteTexture(&ShadowComponent_ShadowTex);
 	}
@@ -16,7 +16,7 @@ extern struct IGameComponent Entities_Component;
 
 /* Offset used to avoid floating point roundoff errors. */
 #define ENTITY_ADJUSTMENT 0.001f
-#define ENTITIES_MAX_COUNT 256
+/* NOTE: ENTITIES_MAX_COUNT is defined in Core.h */
 #define ENTITIES_SELF_ID 255
 
 enum NameMode {
@@ -86,7 +86,7 @@ struct Entity {
 	uint8_t SkinFetchState;
 	bool NoShade, OnGround;
 	GfxResourceID TextureId, MobTextureId;
-	float uScale, vScale;
+	float uScale, vScale, uOffset, vOffset;
 	struct Matrix Transform;
 
 	struct AnimatedComp Anim;
@@ -131,6 +131,8 @@ void Entity_SetSkin(struct Entity* e, const String* skin);
 CC_VAR extern struct _EntitiesData {
 	struct Entity* List[ENTITIES_MAX_COUNT];
 	uint8_t NamesMode, ShadowsMode;
+	/* Number of nametags drawn in the last frame */
+	int NamesDrawn;
 } Entities;
 
 /* Ticks all entities. */
@@ -145,10 +147,16 @@ void Entities_RenderHoveredNames(double delta);
 void Entities_Remove(EntityID id);
 /* Gets the ID of the closest entity to the given entity. */
 EntityID Entities_GetCloset(struct Entity* src);
+/* Rebuilds the spatial grid used by Entities_GetCloset and Entities_QueryArea. */
+/* NOTE: Automatically called before entities are ticked and after they are rendered. */
+void EntitiesGrid_Update(void);
+/* Retrieves IDs of entities which may lie within the given area on the XZ plane, in ascending order. */
+/* NOTE: ids must have room for ENTITIES_MAX_COUNT IDs. Returns number of IDs retrieved. */
+int Entities_QueryArea(float minX, float minZ, float maxX, float maxZ, EntityID* ids);
 /* Draws shadows under entities, depending on Entities.ShadowsMode */
 void Entities_DrawShadows(void);
 
-#define TABLIST_MAX_NAMES 256
+#define TABLIST_MAX_NAMES ENTITIES_MAX_COUNT
 /* Data for all entries in tab list */
 CC_VAR extern struct _TabListData {
 	/* Buffer indices for player/list/group names. */
@@ -180,7 +188,12 @@ struct NetPlayer {
 	bool ShouldRender;
 };
 void NetPlayer_Init(struct NetPlayer* player);
-extern struct NetPlayer NetPlayers_List[ENTITIES_SELF_ID];
+extern struct NetPlayer NetPlayers_List[ENTITIES_MAX_COUNT];
+/* Interpolates position and orientation of all network players at once. */
+/* NOTE: Called by Entities_RenderModels before rendering, so usually you don't need to call this. */
+void NetPlayers_Interpolate(float t);
+/* Marks that network players were added/removed, or their interpolation states changed. */
+void NetPlayers_MarkChanged(void);
 
 /* Represents the user/player's own entity. */
 struct LocalPlayer {
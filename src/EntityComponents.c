@@ -90,22 +90,25 @@ void AnimatedComp_GetCurrent(struct Entity* e, float t) {
 	float idleTime = (float)Game.Time;
 	float idleXRot = Math_SinF(idleTime * ANIM_IDLE_XPERIOD) * ANIM_IDLE_MAX;
 	float idleZRot = Math_CosF(idleTime * ANIM_IDLE_ZPERIOD) * ANIM_IDLE_MAX + ANIM_IDLE_MAX;
+	float walkCos, walkSin;
 
 	anim->Swing       = Math_Lerp(anim->SwingO,       anim->SwingN,       t);
 	anim->WalkTime    = Math_Lerp(anim->WalkTimeO,    anim->WalkTimeN,    t);
 	anim->BobStrength = Math_Lerp(anim->BobStrengthO, anim->BobStrengthN, t);
+	walkCos = Math_CosF(anim->WalkTime);
+	walkSin = Math_SinF(anim->WalkTime);
 
-	anim->LeftArmX =  (Math_CosF(anim->WalkTime) * anim->Swing * ANIM_ARM_MAX) - idleXRot;
+	anim->LeftArmX =  (walkCos * anim->Swing * ANIM_ARM_MAX) - idleXRot;
 	anim->LeftArmZ = -idleZRot;
-	anim->LeftLegX = -(Math_CosF(anim->WalkTime) * anim->Swing * ANIM_LEG_MAX);
+	anim->LeftLegX = -(walkCos * anim->Swing * ANIM_LEG_MAX);
 	anim->LeftLegZ = 0;
 
 	anim->RightLegX = -anim->LeftLegX; anim->RightLegZ = -anim->LeftLegZ;
 	anim->RightArmX = -anim->LeftArmX; anim->RightArmZ = -anim->LeftArmZ;
 
-	anim->BobbingHor   = Math_CosF(anim->WalkTime)            * anim->Swing * (2.5f/16.0f);
-	anim->BobbingVer   = Math_AbsF(Math_SinF(anim->WalkTime)) * anim->Swing * (2.5f/16.0f);
-	anim->BobbingModel = Math_AbsF(Math_CosF(anim->WalkTime)) * anim->Swing * (4.0f/16.0f);
+	anim->BobbingHor   = walkCos            * anim->Swing * (2.5f/16.0f);
+	anim->BobbingVer   = Math_AbsF(walkSin) * anim->Swing * (2.5f/16.0f);
+	anim->BobbingModel = Math_AbsF(walkCos) * anim->Swing * (4.0f/16.0f);
 
 	if (e->Model->CalcHumanAnims && !Game_SimpleArmsAnim) {
 		AnimatedComp_CalcHumanAnim(anim, idleXRot, idleZRot);
@@ -1201,16 +1204,21 @@ float PhysicsComp_CalcJumpVelocity(float jumpHeight) {
 }
 
 void PhysicsComp_DoEntityPush(struct Entity* entity) {
+	EntityID ids[ENTITIES_MAX_COUNT];
 	struct Entity* other;
 	bool yIntersects;
 	Vec3 dir;
 	float dist, pushStrength;
-	int id;
+	int i, count;
 	dir.Y = 0.0f;
 
-	for (id = 0; id < ENTITIES_MAX_COUNT; id++) {
-		other = Entities.List[id];
-		if (!other || other == entity) continue;
+	/* only entities within 1 block horizontally can push */
+	count = Entities_QueryArea(entity->Position.X - 1.0f, entity->Position.Z - 1.0f,
+							   entity->Position.X + 1.0f, entity->Position.Z + 1.0f, ids);
+
+	for (i = 0; i < count; i++) {
+		other = Entities.List[ids[i]];
+		if (other == entity) continue;
 		if (!other->Model->Pushes)     continue;
 
 		yIntersects =
@@ -368,7 +368,7 @@ static IVec3 weather_lastPos;
 
 static void EnvRenderer_InitWeatherHeightmap(void) {
 	int i;
-	Weather_Heightmap = (int16_t*)Mem_Alloc(World.Width * World.Length, 2, "weather heightmap");
+	Weather_Heightmap = (int16_t*)Arena_Alloc(&World_MapArena, World.Width * World.Length, 2, "weather heightmap");
 	
 	for (i = 0; i < World.Width * World.Length; i++) {
 		Weather_Heightmap[i] = Int16_MaxValue;
@@ -932,7 +932,6 @@ static void EnvRenderer_Free(void) {
 	Event_UnregisterVoid(&GfxEvents.ContextRecreated,    NULL, EnvRenderer_ContextRecreated);
 
 	EnvRenderer_ContextLost(NULL);
-	Mem_Free(Weather_Heightmap);
 	Weather_Heightmap = NULL;
 
 	Gfx_DeleteTexture(&clouds_tex);
@@ -945,7 +944,7 @@ static void EnvRenderer_Reset(void) {
 	Gfx_SetFog(false);
 	EnvRenderer_DeleteVbs();
 
-	Mem_Free(Weather_Heightmap);
+	/* Heightmap is freed along with the rest of World_MapArena */
 	Weather_Heightmap = NULL;
 	weather_lastPos   = IVec3_MaxValue();
 }
@@ -1,5 +1,6 @@
 #include "Event.h"
 #include "Logger.h"
+#include "Platform.h"
 
 struct _EntityEventsList  EntityEvents;
 struct _TabListEventsList TabListEvents;
@@ -14,21 +15,50 @@ struct _KeyEventsList     KeyEvents;
 struct _MouseEventsList   MouseEvents;
 struct _NetEventsList     NetEvents;
 
+static void Event_Grow(struct Event_Void* handlers) {
+	int capacity;
+	/* NOTE: Mem_Realloc can't be used on NULL with all platforms */
+	if (!handlers->Capacity) {
+		capacity = 8;
+		handlers->Handlers   = (Event_Void_Callback*)Mem_Alloc(capacity, sizeof(Event_Void_Callback), "event handlers");
+		handlers->Objs       = (void**)Mem_Alloc(capacity,               sizeof(void*),               "event objs");
+		handlers->Priorities = (int*)Mem_Alloc(capacity,                 sizeof(int),                 "event priorities");
+	} else {
+		capacity = handlers->Capacity * 2;
+		handlers->Handlers   = (Event_Void_Callback*)Mem_Realloc(handlers->Handlers, capacity, sizeof(Event_Void_Callback), "event handlers");
+		handlers->Objs       = (void**)Mem_Realloc(handlers->Objs,                   capacity, sizeof(void*),               "event objs");
+		handlers->Priorities = (int*)Mem_Realloc(handlers->Priorities,               capacity, sizeof(int),                 "event priorities");
+	}
+	handlers->Capacity = capacity;
+}
+
 void Event_Register(struct Event_Void* handlers, void* obj, Event_Void_Callback handler) {
-	int i;
+	Event_RegisterPriority(handlers, obj, handler, EVENT_PRIORITY_NORMAL);
+}
+
+void Event_RegisterPriority(struct Event_Void* handlers, void* obj, Event_Void_Callback handler, int priority) {
+	int i, j;
 	for (i = 0; i < handlers->Count; i++) {
 		if (handlers->Handlers[i] == handler && handlers->Objs[i] == obj) {
 			Logger_Abort("Attempt to register event handler that was already registered");
 		}
 	}
+	if (handlers->Count == handlers->Capacity) Event_Grow(handlers);
 
-	if (handlers->Count == EVENT_MAX_CALLBACKS) {
-		Logger_Abort("Unable to register another event handler");
-	} else {
-		handlers->Handlers[handlers->Count] = handler;
-		handlers->Objs[handlers->Count]     = obj;
-		handlers->Count++;
+	/* Insert after all handlers with same or higher priority */
+	for (i = 0; i < handlers->Count; i++) {
+		if (handlers->Priorities[i] < priority) break;
+	}
+	for (j = handlers->Count; j > i; j--) {
+		handlers->Handlers[j]   = handlers->Handlers[j - 1];
+		handlers->Objs[j]       = handlers->Objs[j - 1];
+		handlers->Priorities[j] = handlers->Priorities[j - 1];
 	}
+
+	handlers->Handlers[i]   = handler;
+	handlers->Objs[i]       = obj;
+	handlers->Priorities[i] = priority;
+	handlers->Count++;
 }
 
 void Event_Unregister(struct Event_Void* handlers, void* obj, Event_Void_Callback handler) {
@@ -38,8 +68,9 @@ void Event_Unregister(struct Event_Void* handlers, void* obj, Event_Void_Callbac
 
 		/* Remove this handler from the list, by shifting all following handlers left */
 		for (j = i; j < handlers->Count - 1; j++) {
-			handlers->Handlers[j] = handlers->Handlers[j + 1];
-			handlers->Objs[j]     = handlers->Objs[j + 1];
+			handlers->Handlers[j]   = handlers->Handlers[j + 1];
+			handlers->Objs[j]       = handlers->Objs[j + 1];
+			handlers->Priorities[j] = handlers->Priorities[j + 1];
 		}
 		
 		handlers->Count--;
@@ -105,3 +136,10 @@ void Event_RaiseInput(struct Event_Input* handlers, int key, bool repeating) {
 		handlers->Handlers[i](handlers->Objs[i], key, repeating);
 	}
 }
+
+void Event_RaiseBlockBatch(struct Event_BlockBatch* handlers, const struct BlockChange* changes, int count) {
+	int i;
+	for (i = 0; i < handlers->Count; i++) {
+		handlers->Handlers[i](handlers->Objs[i], changes, count);
+	}
+}
@@ -6,66 +6,55 @@
    Copyright 2014-2019 ClassiCube | Licensed under BSD-3
 */
 
-/* Max callbacks that can be registered for an event. */
-#define EVENT_MAX_CALLBACKS 32
+/* Default priority of callbacks registered for an event. */
+#define EVENT_PRIORITY_NORMAL 0
 struct Stream;
 
+/* Fields common to every event type. Arrays are grown on demand as callbacks are registered. */
+/* Handlers are kept sorted by priority (highest first), then in order of registration. */
+#define Event_Layout(callback) callback* Handlers; void** Objs; int* Priorities; int Count, Capacity;
+
 typedef void (*Event_Void_Callback)(void* obj);
-struct Event_Void {
-	Event_Void_Callback Handlers[EVENT_MAX_CALLBACKS]; 
-	void* Objs[EVENT_MAX_CALLBACKS]; int Count;
-};
+struct Event_Void { Event_Layout(Event_Void_Callback) };
 
 typedef void (*Event_Int_Callback)(void* obj, int argument);
-struct Event_Int {
-	Event_Int_Callback Handlers[EVENT_MAX_CALLBACKS];
-	void* Objs[EVENT_MAX_CALLBACKS]; int Count;
-};
+struct Event_Int { Event_Layout(Event_Int_Callback) };
 
 typedef void (*Event_Float_Callback)(void* obj, float argument);
-struct Event_Float {
-	Event_Float_Callback Handlers[EVENT_MAX_CALLBACKS];
-	void* Objs[EVENT_MAX_CALLBACKS]; int Count;
-};
+struct Event_Float { Event_Layout(Event_Float_Callback) };
 
 typedef void (*Event_Entry_Callback)(void* obj, struct Stream* stream, const String* name);
-struct Event_Entry {
-	Event_Entry_Callback Handlers[EVENT_MAX_CALLBACKS];
-	void* Objs[EVENT_MAX_CALLBACKS]; int Count;
-};
+struct Event_Entry { Event_Layout(Event_Entry_Callback) };
 
 typedef void (*Event_Block_Callback)(void* obj, IVec3 coords, BlockID oldBlock, BlockID block);
-struct Event_Block {
-	Event_Block_Callback Handlers[EVENT_MAX_CALLBACKS];
-	void* Objs[EVENT_MAX_CALLBACKS]; int Count;
-};
+struct Event_Block { Event_Layout(Event_Block_Callback) };
 
 typedef void (*Event_MouseMove_Callback)(void* obj, int xDelta, int yDelta);
-struct Event_MouseMove {
-	Event_MouseMove_Callback Handlers[EVENT_MAX_CALLBACKS];
-	void* Objs[EVENT_MAX_CALLBACKS]; int Count;
-};
+struct Event_MouseMove { Event_Layout(Event_MouseMove_Callback) };
 
 typedef void (*Event_Chat_Callback)(void* obj, const String* msg, int msgType);
-struct Event_Chat {
-	Event_Chat_Callback Handlers[EVENT_MAX_CALLBACKS];
-	void* Objs[EVENT_MAX_CALLBACKS]; int Count;
-};
+struct Event_Chat { Event_Layout(Event_Chat_Callback) };
 
 typedef void (*Event_Input_Callback)(void* obj, int key, bool repeating);
-struct Event_Input {
-	Event_Input_Callback Handlers[EVENT_MAX_CALLBACKS];
-	void* Objs[EVENT_MAX_CALLBACKS]; int Count;
-};
+struct Event_Input { Event_Layout(Event_Input_Callback) };
+
+/* A single block change, as delivered to Event_BlockBatch callbacks. */
+struct BlockChange { IVec3 Coords; BlockID OldBlock, Block; };
+typedef void (*Event_BlockBatch_Callback)(void* obj, const struct BlockChange* changes, int count);
+struct Event_BlockBatch { Event_Layout(Event_BlockBatch_Callback) };
 
-/* Registers a callback function for the given event. */
-/* NOTE: Trying to register a callback twice or over EVENT_MAX_CALLBACKS callbacks will terminate the game. */
+/* Registers a callback function for the given event, with EVENT_PRIORITY_NORMAL priority. */
+/* NOTE: Trying to register a callback twice will terminate the game. */
 CC_API void Event_Register(struct Event_Void* handlers,   void* obj, Event_Void_Callback handler);
+/* Registers a callback function for the given event, called before all callbacks of lower priority. */
+/* Callbacks with the same priority are called in the order they were registered. */
+CC_API void Event_RegisterPriority(struct Event_Void* handlers, void* obj, Event_Void_Callback handler, int priority);
 /* Unregisters a callback function for the given event. */
 /* NOTE: Trying to unregister a non-registered callback will terminate the game. */
 CC_API void Event_Unregister(struct Event_Void* handlers, void* obj, Event_Void_Callback handler);
 #define Event_RegisterMacro(handlers,   obj, handler) Event_Register((struct Event_Void*)(handlers),   obj, (Event_Void_Callback)(handler))
 #define Event_UnregisterMacro(handlers, obj, handler) Event_Unregister((struct Event_Void*)(handlers), obj, (Event_Void_Callback)(handler))
+#define Event_RegisterPriorityMacro(handlers, obj, handler, priority) Event_RegisterPriority((struct Event_Void*)(handlers), obj, (Event_Void_Callback)(handler), priority)
 
 /* Calls all registered callback for an event with no arguments. */
 CC_API void Event_RaiseVoid(struct Event_Void* handlers);
@@ -114,6 +103,12 @@ void Event_RaiseInput(struct Event_Input* handlers, int key, bool repeating);
 #define Event_RegisterInput(handlers,   obj, handler) Event_RegisterMacro(handlers,   obj, handler)
 #define Event_UnregisterInput(handlers, obj, handler) Event_UnregisterMacro(handlers, obj, handler)
 
+/* Calls all registered callbacks for an event which takes a batch of block changes. */
+/* Changes are in the order they were made. A block may appear more than once in a batch. */
+void Event_RaiseBlockBatch(struct Event_BlockBatch* handlers, const struct BlockChange* changes, int count);
+#define Event_RegisterBlockBatch(handlers,   obj, handler) Event_RegisterMacro(handlers,   obj, handler)
+#define Event_UnregisterBlockBatch(handlers, obj, handler) Event_UnregisterMacro(handlers, obj, handler)
+
 CC_VAR extern struct _EntityEventsList {
 	struct Event_Int Added;    /* Entity is spawned in the current world */
 	struct Event_Int Removed;  /* Entity is despawned from the current world */
@@ -155,6 +150,7 @@ CC_VAR extern struct _WorldEventsList {
 	struct Event_Float Loading;       /* Portion of world is decompressed/generated (Arg is progress from 0-1) */
 	struct Event_Void  MapLoaded;     /* New world has finished loading, player can now interact with it */
 	struct Event_Int   EnvVarChanged; /* World environment variable changed by player/CPE/WoM config */
+	struct Event_BlockBatch BlocksChanged; /* Blocks changed by anything (user/physics/server), raised at end of frame or when 256 changes are buffered */
 } WorldEvents;
 
 CC_VAR extern struct _ChatEventsList {
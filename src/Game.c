@@ -32,6 +32,9 @@
 #include "Menus.h"
 #include "Audio.h"
 #include "Stream.h"
+#include "Physics.h"
+#include "Profiler.h"
+#include "Platform.h"
 
 struct _GameData Game;
 int  Game_Port;
@@ -197,16 +200,44 @@ void Game_Reset(void) {
 	}
 }
 
+/* Block changes are only buffered when something is listening for them */
+#define GAME_MAX_BLOCK_CHANGES 256
+static struct BlockChange blockChanges[GAME_MAX_BLOCK_CHANGES];
+static int blockChangesCount;
+
+static void Game_FlushBlockChanges(void) {
+	struct BlockChange changes[GAME_MAX_BLOCK_CHANGES];
+	int count = blockChangesCount;
+	if (!count) return;
+
+	/* Handlers may change blocks too, which would overwrite blockChanges while it is being raised */
+	Mem_Copy(changes, blockChanges, count * sizeof(struct BlockChange));
+	blockChangesCount = 0;
+	Event_RaiseBlockBatch(&WorldEvents.BlocksChanged, changes, count);
+}
+
+static void Game_AddBlockChange(int x, int y, int z, BlockID old, BlockID block) {
+	struct BlockChange* change;
+	if (blockChangesCount == GAME_MAX_BLOCK_CHANGES) Game_FlushBlockChanges();
+
+	change = &blockChanges[blockChangesCount++];
+	change->Coords.X = x; change->Coords.Y = y; change->Coords.Z = z;
+	change->OldBlock = old;
+	change->Block    = block;
+}
+
 void Game_UpdateBlock(int x, int y, int z, BlockID block) {
 	struct ChunkInfo* chunk;
 	int cx = x >> 4, cy = y >> 4, cz = z >> 4;
 	BlockID old = World_GetBlock(x, y, z);
 	World_SetBlock(x, y, z, block);
+	if (WorldEvents.BlocksChanged.Count) Game_AddBlockChange(x, y, z, old, block);
 
 	if (Weather_Heightmap) {
 		EnvRenderer_OnBlockChanged(x, y, z, old, block);
 	}
 	Lighting_OnBlockChanged(x, y, z, old, block);
+	Searcher_OnBlockChanged(x, y, z, block);
 
 	/* Refresh the chunk the block was located in. */
 	chunk = MapRenderer_GetChunk(cx, cy, cz);
@@ -284,9 +315,18 @@ static void Game_OnResize(void* obj) {
 
 static void Game_OnNewMapCore(void* obj) {
 	struct IGameComponent* comp;
+	int usedKB, highKB;
+	/* Changes to the old map are meaningless now */
+	blockChangesCount = 0;
 	for (comp = comps_head; comp; comp = comp->next) {
 		if (comp->OnNewMap) comp->OnNewMap();
 	}
+
+	/* Nothing references data sized to the old map anymore */
+	usedKB = (int)((World_MapArena.used + World_MapArena.blocksSize) / 1024);
+	highKB = (int)(World_MapArena.highWater / 1024);
+	if (usedKB) Platform_Log2("Map arena: %i KB used by last map, high water mark %i KB", &usedKB, &highKB);
+	Arena_Reset(&World_MapArena);
 }
 
 static void Game_OnNewMapLoadedCore(void* obj) {
@@ -419,6 +459,47 @@ static void Game_LoadPlugins(void) {
 }
 #endif
 
+#ifdef CC_BUILD_MEMTRACK
+static bool mem_marked;
+/* Called after everything has freed state associated with the old map */
+static void Game_CheckMemoryLeaks(void* obj) {
+	static struct MemTag tags[MEM_MAX_TAGS];
+	uint64_t live, peak;
+	int i, count, grown;
+
+	count = Mem_GetTags(tags, &live, &peak);
+	for (i = 0; mem_marked && i < count; i++) {
+		if (tags[i].Live <= tags[i].Mark) continue;
+
+		grown = (int)(tags[i].Live - tags[i].Mark);
+		Platform_Log2("Possible leak: %c grew by %i bytes across map change", tags[i].Place, &grown);
+	}
+
+	mem_marked = true;
+	Mem_MarkTags();
+}
+
+static void Game_DumpMemory(void) {
+	static struct MemTag tags[MEM_MAX_TAGS];
+	uint64_t live, peak;
+	int i, count, liveKB, peakKB, allocs, leaked;
+
+	count  = Mem_GetTags(tags, &live, &peak);
+	peakKB = (int)(peak / 1024);
+	Platform_Log1("Memory: peak of %i KB allocated", &peakKB);
+
+	for (i = 0; i < count; i++) {
+		peakKB = (int)(tags[i].Peak / 1024);
+		allocs = tags[i].Allocs;
+		leaked = tags[i].Allocs - tags[i].Frees;
+		Platform_Log4("  %c: peak %i KB, %i allocations, %i not freed", tags[i].Place, &peakKB, &allocs, &leaked);
+	}
+
+	liveKB = (int)(live / 1024);
+	if (live) Platform_Log1("Memory: %i KB still allocated at shutdown", &liveKB);
+}
+#endif
+
 void Game_Free(void* obj);
 static void Game_Load(void) {
 	struct IGameComponent* comp;
@@ -442,6 +523,9 @@ static void Game_Load(void) {
 
 	Event_RegisterVoid(&WindowEvents.Resized,       NULL, Game_OnResize);
 	Event_RegisterVoid(&WindowEvents.Closing,       NULL, Game_Free);
+#ifdef CC_BUILD_MEMTRACK
+	Event_RegisterPriority(&WorldEvents.NewMap, NULL, Game_CheckMemoryLeaks, EVENT_PRIORITY_NORMAL - 1);
+#endif
 
 	TextureCache_Init();
 	/* TODO: Survival vs Creative game mode */
@@ -451,15 +535,18 @@ static void Game_Load(void) {
 	Game_AddComponent(&Drawer2D_Component);
 
 	Game_AddComponent(&Chat_Component);
+	Game_AddComponent(&Profiler_Component);
 	Game_AddComponent(&Particles_Component);
 	Game_AddComponent(&TabList_Component);
 
 	Game_AddComponent(&Models_Component);
 	Game_AddComponent(&Entities_Component);
+	Game_AddComponent(&Searcher_Component);
 	Game_AddComponent(&Http_Component);
 	Game_AddComponent(&Lighting_Component);
 
 	Game_AddComponent(&Animations_Component);
+	Game_AddComponent(&TexturePack_Component);
 	Game_AddComponent(&Inventory_Component);
 	World_Reset();
 
@@ -519,21 +606,40 @@ static void Game_Render3D(double delta, float t) {
 	Vec3 pos;
 	bool left, middle, right;
 
-	if (EnvRenderer_ShouldRenderSkybox()) EnvRenderer_RenderSkybox(delta);
+	if (EnvRenderer_ShouldRenderSkybox()) {
+		Profiler_Begin(PROFILE_ENVIRONMENT);
+		EnvRenderer_RenderSkybox(delta);
+		Profiler_End(PROFILE_ENVIRONMENT);
+	}
 	AxisLinesRenderer_Render(delta);
+
+	Profiler_Begin(PROFILE_ENTITIES);
 	Entities_RenderModels(delta, t);
 	Entities_RenderNames(delta);
+	Profiler_End(PROFILE_ENTITIES);
 
+	Profiler_Begin(PROFILE_PARTICLES);
 	Particles_Render(delta, t);
+	Profiler_End(PROFILE_PARTICLES);
 	Camera.Active->GetPickedBlock(&Game_SelectedPos); /* TODO: only pick when necessary */
 
+	Profiler_Begin(PROFILE_ENVIRONMENT);
 	EnvRenderer_UpdateFog();
 	EnvRenderer_RenderSky(delta);
 	EnvRenderer_RenderClouds(delta);
+	Profiler_End(PROFILE_ENVIRONMENT);
 
+	Profiler_Begin(PROFILE_MAP_UPDATE);
 	MapRenderer_Update(delta);
+	Profiler_End(PROFILE_MAP_UPDATE);
+
+	Profiler_Begin(PROFILE_MAP_NORMAL);
 	MapRenderer_RenderNormal(delta);
+	Profiler_End(PROFILE_MAP_NORMAL);
+
+	Profiler_Begin(PROFILE_ENVIRONMENT);
 	EnvRenderer_RenderMapSides(delta);
+	Profiler_End(PROFILE_ENVIRONMENT);
 
 	Entities_DrawShadows();
 	if (Game_SelectedPos.Valid && !Game_HideGui) {
@@ -544,11 +650,21 @@ static void Game_Render3D(double delta, float t) {
 	/* Render water over translucent blocks when underwater for proper alpha blending */
 	pos = LocalPlayer_Instance.Base.Position;
 	if (Camera.CurrentPos.Y < Env.EdgeHeight && (pos.X < 0 || pos.Z < 0 || pos.X > World.Width || pos.Z > World.Length)) {
+		Profiler_Begin(PROFILE_MAP_TRANSLUCENT);
 		MapRenderer_RenderTranslucent(delta);
+		Profiler_End(PROFILE_MAP_TRANSLUCENT);
+
+		Profiler_Begin(PROFILE_ENVIRONMENT);
 		EnvRenderer_RenderMapEdges(delta);
+		Profiler_End(PROFILE_ENVIRONMENT);
 	} else {
+		Profiler_Begin(PROFILE_ENVIRONMENT);
 		EnvRenderer_RenderMapEdges(delta);
+		Profiler_End(PROFILE_ENVIRONMENT);
+
+		Profiler_Begin(PROFILE_MAP_TRANSLUCENT);
 		MapRenderer_RenderTranslucent(delta);
+		Profiler_End(PROFILE_MAP_TRANSLUCENT);
 	}
 
 	/* Need to render again over top of translucent block, as the selection outline */
@@ -631,6 +747,7 @@ static void Game_RenderFrame(double delta) {
 		return;
 	}
 
+	Profiler_Begin(PROFILE_FRAME);
 	Gfx_BeginFrame();
 	Gfx_BindIb(Gfx_defaultIb);
 	Game.Time += delta;
@@ -647,7 +764,10 @@ static void Game_RenderFrame(double delta) {
 		InputHandler_SetFOV(Game_ZoomFov);
 	}
 
+	Profiler_Begin(PROFILE_TASKS);
 	Game_DoScheduledTasks(delta);
+	Game_FlushBlockChanges();
+	Profiler_End(PROFILE_TASKS);
 	entTask = Game_Tasks[entTaskI];
 	t = (float)(entTask.Accumulator / entTask.Interval);
 	LocalPlayer_SetInterpPosition(t);
@@ -658,14 +778,24 @@ static void Game_RenderFrame(double delta) {
 
 	visible = !Gui_Active || !Gui_Active->blocksWorld;
 	if (visible && World.Blocks) {
+		Profiler_Begin(PROFILE_RENDER3D);
 		Game_Render3D(delta, t);
+		Profiler_End(PROFILE_RENDER3D);
 	} else {
 		PickedPos_SetAsInvalid(&Game_SelectedPos);
 	}
 
+	Profiler_Begin(PROFILE_GUI);
 	Gui_RenderGui(delta);
+	Profiler_End(PROFILE_GUI);
 	if (Game_ScreenshotRequested) Game_TakeScreenshot();
+
+	Profiler_Begin(PROFILE_END_FRAME);
 	Gfx_EndFrame();
+	Profiler_End(PROFILE_END_FRAME);
+
+	Profiler_End(PROFILE_FRAME);
+	Profiler_EndFrame();
 }
 
 void Game_Free(void* obj) {
@@ -679,13 +809,20 @@ void Game_Free(void* obj) {
 
 	Event_UnregisterVoid(&WindowEvents.Resized,       NULL, Game_OnResize);
 	Event_UnregisterVoid(&WindowEvents.Closing,       NULL, Game_Free);
+#ifdef CC_BUILD_MEMTRACK
+	Event_UnregisterVoid(&WorldEvents.NewMap,         NULL, Game_CheckMemoryLeaks);
+#endif
 
 	for (comp = comps_head; comp; comp = comp->next) {
 		if (comp->Free) comp->Free();
 	}
+	Arena_Free(&World_MapArena);
 
 	Logger_WarnFunc = Logger_DialogWarn;
 	Gfx_Free();
+#ifdef CC_BUILD_MEMTRACK
+	Game_DumpMemory();
+#endif
 
 	if (!Options_ChangedCount()) return;
 	Options_Load();
@@ -13,10 +13,49 @@ int Gen_Seed;
 bool Gen_Vanilla;
 BlockRaw* Gen_Blocks;
 
+static uint64_t gen_beg, gen_stageBeg;
+static uint32_t gen_scratchCur, gen_scratchPeak;
+
 static void Gen_Init(void) {
 	Gen_CurrentProgress = 0.0f;
 	Gen_CurrentState    = "";
 	Gen_Done   = false;
+
+	gen_scratchCur = 0; gen_scratchPeak = 0;
+	gen_beg        = Stopwatch_Measure();
+	gen_stageBeg   = gen_beg;
+}
+
+/* Logs how long the current stage took, then moves on to the given stage */
+static void Gen_BeginStage(const char* state) {
+	uint64_t now = Stopwatch_Measure();
+	int elapsed  = (int)(Stopwatch_ElapsedMicroseconds(gen_stageBeg, now) / 1000);
+	int scratch  = (int)(gen_scratchCur >> 10);
+	const char* cur = (const char*)Gen_CurrentState;
+
+	if (cur[0]) {
+		Platform_Log3("Gen: %c took %i ms (scratch %i KB)", cur, &elapsed, &scratch);
+	}
+	gen_stageBeg        = now;
+	Gen_CurrentProgress = 0.0f;
+	Gen_CurrentState    = state;
+}
+
+/* Tracks memory used by temporary buffers that only exist while generating */
+static void Gen_TrackScratch(int delta) {
+	gen_scratchCur += delta;
+	gen_scratchPeak = max(gen_scratchPeak, gen_scratchCur);
+}
+
+static void Gen_Finish(void) {
+	uint64_t now = Stopwatch_Measure();
+	int elapsed  = (int)(Stopwatch_ElapsedMicroseconds(gen_beg, now) / 1000);
+	int blocks   = World.Volume >> 10;
+	int scratch  = (int)(gen_scratchPeak >> 10);
+
+	Gen_BeginStage("");
+	Platform_Log3("Gen: finished in %i ms, peak memory %i KB blocks + %i KB scratch", &elapsed, &blocks, &scratch);
+	Gen_Done = true;
 }
 
 
@@ -30,7 +69,6 @@ static void FlatgrassGen_MapSet(int yBeg, int yEnd, BlockRaw block) {
 
 	yBeg = max(yBeg, 0); yEnd = max(yEnd, 0);
 	yHeight = (yEnd - yBeg) + 1;
-	Gen_CurrentProgress = 0.0f;
 
 	for (y = yBeg; y <= yEnd; y++) {
 		Mem_Set(ptr + y * oneY, block, oneY);
@@ -41,16 +79,16 @@ static void FlatgrassGen_MapSet(int yBeg, int yEnd, BlockRaw block) {
 void FlatgrassGen_Generate(void) {
 	Gen_Init();
 
-	Gen_CurrentState = "Setting air blocks";
+	Gen_BeginStage("Setting air blocks");
 	FlatgrassGen_MapSet(World.Height / 2, World.MaxY, BLOCK_AIR);
 
-	Gen_CurrentState = "Setting dirt blocks";
+	Gen_BeginStage("Setting dirt blocks");
 	FlatgrassGen_MapSet(0, World.Height / 2 - 2, BLOCK_DIRT);
 
-	Gen_CurrentState = "Setting grass blocks";
+	Gen_BeginStage("Setting grass blocks");
 	FlatgrassGen_MapSet(World.Height / 2 - 1, World.Height / 2 - 1, BLOCK_GRASS);
 
-	Gen_Done = true;
+	Gen_Finish();
 }
 
 
@@ -182,13 +220,25 @@ static void NotchyGen_FillOblateSpheroid(int x, int y, int z, float radius, Bloc
 }
 
 #define STACK_FAST 8192
+/* Flood fill stack is reused across all flood fills, instead of allocated per fill */
+static int32_t  floodStackDefault[STACK_FAST];
+static int32_t* floodStack = floodStackDefault;
+static int floodLimit = STACK_FAST;
+
+static void NotchyGen_FreeFloodStack(void) {
+	if (floodLimit > STACK_FAST) {
+		Mem_Free(floodStack);
+		Gen_TrackScratch(-(floodLimit - STACK_FAST) * 4);
+	}
+	floodStack = floodStackDefault;
+	floodLimit = STACK_FAST;
+}
+
 static void NotchyGen_FloodFill(int index, BlockRaw block) {
-	int32_t* stack;
-	int32_t stack_default[STACK_FAST]; /* try to avoid malloc if we can */
-	int count = 0, limit = STACK_FAST;
+	int32_t* stack = floodStack;
+	int count = 0, oldLimit;
 	int x, y, z;
 
-	stack = stack_default;
 	if (index < 0) return; /* y below map, don't bother starting */
 	stack[count++] = index;
 
@@ -202,9 +252,12 @@ static void NotchyGen_FloodFill(int index, BlockRaw block) {
 		y = index  / World.OneY;
 		z = (index / World.Width) % World.Length;
 
-		/* need to increase stack */
-		if (count >= limit - FACE_COUNT) {
-			Utils_Resize((void**)&stack, &limit, 4, STACK_FAST, STACK_FAST);
+		/* need to increase stack (doubles, so huge fills don't keep reallocating) */
+		if (count >= floodLimit - FACE_COUNT) {
+			oldLimit = floodLimit;
+			Utils_Resize((void**)&floodStack, &floodLimit, 4, STACK_FAST, floodLimit);
+			Gen_TrackScratch((floodLimit - oldLimit) * 4);
+			stack = floodStack;
 		}
 
 		if (x > 0)          { stack[count++] = index - 1; }
@@ -213,7 +266,6 @@ static void NotchyGen_FloodFill(int index, BlockRaw block) {
 		if (z < World.MaxZ) { stack[count++] = index + World.Width; }
 		if (y > 0)          { stack[count++] = index - World.OneY; }
 	}
-	if (limit > STACK_FAST) Mem_Free(stack);
 }
 
 
@@ -228,7 +280,7 @@ static void NotchyGen_CreateHeightmap(void) {
 	CombinedNoise_Init(&n2, &rnd, 8, 8);	
 	OctaveNoise_Init(&n3, &rnd, 6);
 
-	Gen_CurrentState = "Building heightmap";
+	Gen_BeginStage("Building heightmap");
 	for (z = 0; z < World.Length; z++) {
 		Gen_CurrentProgress = (float)z / World.Length;
 
@@ -256,8 +308,7 @@ static int NotchyGen_CreateStrataFast(void) {
 	int stoneHeight, airHeight;
 	int y;
 
-	Gen_CurrentProgress = 0.0f;
-	Gen_CurrentState    = "Filling map";
+	Gen_BeginStage("Filling map");
 	/* Make lava layer at bottom */
 	Mem_Set(Gen_Blocks, BLOCK_LAVA, oneY);
 
@@ -291,7 +342,7 @@ static void NotchyGen_CreateStrata(void) {
 	minStoneY = NotchyGen_CreateStrataFast();
 	OctaveNoise_Init(&n, &rnd, 8);
 
-	Gen_CurrentState = "Creating strata";
+	Gen_BeginStage("Creating strata");
 	for (z = 0; z < World.Length; z++) {
 		Gen_CurrentProgress = (float)z / World.Length;
 
@@ -326,7 +377,7 @@ static void NotchyGen_CarveCaves(void) {
 	int i, j;
 
 	cavesCount       = World.Volume / 8192;
-	Gen_CurrentState = "Carving caves";
+	Gen_BeginStage("Carving caves");
 	for (i = 0; i < cavesCount; i++) {
 		Gen_CurrentProgress = (float)i / cavesCount;
 
@@ -370,7 +421,7 @@ static void NotchyGen_CarveOreVeins(float abundance, const char* state, BlockRaw
 	int i, j;
 
 	numVeins         = (int)(World.Volume * abundance / 16384);
-	Gen_CurrentState = state;
+	Gen_BeginStage(state);
 	for (i = 0; i < numVeins; i++) {
 		Gen_CurrentProgress = (float)i / numVeins;
 
@@ -402,7 +453,7 @@ static void NotchyGen_FloodFillWaterBorders(void) {
 	int waterY = waterLevel - 1;
 	int index1, index2;
 	int x, z;
-	Gen_CurrentState = "Flooding edge water";
+	Gen_BeginStage("Flooding edge water");
 
 	index1 = World_Pack(0, waterY, 0);
 	index2 = World_Pack(0, waterY, World.Length - 1);
@@ -430,7 +481,7 @@ static void NotchyGen_FloodFillWater(void) {
 	int i, x, y, z;
 
 	numSources       = World.Width * World.Length / 800;
-	Gen_CurrentState = "Flooding water";
+	Gen_BeginStage("Flooding water");
 	for (i = 0; i < numSources; i++) {
 		Gen_CurrentProgress = (float)i / numSources;
 
@@ -446,7 +497,7 @@ static void NotchyGen_FloodFillLava(void) {
 	int i, x, y, z;
 
 	numSources       = World.Width * World.Length / 20000;
-	Gen_CurrentState = "Flooding lava";
+	Gen_BeginStage("Flooding lava");
 	for (i = 0; i < numSources; i++) {
 		Gen_CurrentProgress = (float)i / numSources;
 
@@ -466,7 +517,7 @@ static void NotchyGen_CreateSurfaceLayer(void) {
 	OctaveNoise_Init(&n1, &rnd, 8);
 	OctaveNoise_Init(&n2, &rnd, 8);
 
-	Gen_CurrentState = "Creating surface";
+	Gen_BeginStage("Creating surface");
 	for (z = 0; z < World.Length; z++) {
 		Gen_CurrentProgress = (float)z / World.Length;
 
@@ -495,7 +546,7 @@ static void NotchyGen_PlantFlowers(void) {
 	int i, j, k, index;
 
 	numPatches       = World.Width * World.Length / 3000;
-	Gen_CurrentState = "Planting flowers";
+	Gen_BeginStage("Planting flowers");
 	for (i = 0; i < numPatches; i++) {
 		Gen_CurrentProgress = (float)i / numPatches;
 
@@ -529,7 +580,7 @@ static void NotchyGen_PlantMushrooms(void) {
 	int i, j, k, index;
 
 	numPatches       = World.Volume / 2000;
-	Gen_CurrentState = "Planting mushrooms";
+	Gen_BeginStage("Planting mushrooms");
 	for (i = 0; i < numPatches; i++) {
 		Gen_CurrentProgress = (float)i / numPatches;
 
@@ -571,7 +622,7 @@ static void NotchyGen_PlantTrees(void) {
 	Tree_Rnd    = &rnd;
 
 	numPatches       = World.Width * World.Length / 4000;
-	Gen_CurrentState = "Planting trees";
+	Gen_BeginStage("Planting trees");
 	for (i = 0; i < numPatches; i++) {
 		Gen_CurrentProgress = (float)i / numPatches;
 
@@ -606,8 +657,17 @@ static void NotchyGen_PlantTrees(void) {
 }
 
 void NotchyGen_Generate(void) {
+	uint32_t heightmapSize = (uint32_t)World.Width * World.Length * 2;
 	Gen_Init();
-	Heightmap = (int16_t*)Mem_Alloc(World.Width * World.Length, 2, "gen heightmap");
+
+	/* Fail gracefully instead of exiting, as this is the only other large allocation */
+	Heightmap = (int16_t*)Mem_TryAlloc(heightmapSize, 1);
+	if (!Heightmap) {
+		Mem_Free(Gen_Blocks);
+		Gen_Blocks = NULL;
+		Gen_Done   = true; return;
+	}
+	Gen_TrackScratch(heightmapSize);
 
 	Random_Seed(&rnd, Gen_Seed);
 	waterLevel = World.Height / 2;	
@@ -623,6 +683,7 @@ void NotchyGen_Generate(void) {
 	NotchyGen_FloodFillWaterBorders();
 	NotchyGen_FloodFillWater();
 	NotchyGen_FloodFillLava();
+	NotchyGen_FreeFloodStack();
 
 	NotchyGen_CreateSurfaceLayer();
 	NotchyGen_PlantFlowers();
@@ -630,8 +691,9 @@ void NotchyGen_Generate(void) {
 	NotchyGen_PlantTrees();
 
 	Mem_Free(Heightmap);
+	Gen_TrackScratch(-(int)heightmapSize);
 	Heightmap = NULL;
-	Gen_Done  = true;
+	Gen_Finish();
 }
 
 
@@ -226,26 +226,40 @@ static BitmapCol Gfx_Average(BitmapCol p1, BitmapCol p2) {
 	return ave;
 }
 
-void Gfx_GenMipmaps(int width, int height, uint8_t* lvlScan0, uint8_t* scan0) {
+/* Averages every byte of two colours at once. Same as Gfx_Average when both are fully opaque */
+#define Gfx_AverageOpaque(a, b) (((a) & (b)) + ((((a) ^ (b)) & 0xFEFEFEFEUL) >> 1))
+
+void Gfx_GenMipmaps(int width, int height, uint8_t* lvlScan0, uint8_t* scan0, int srcWidth, int srcHeight) {
 	BitmapCol* baseSrc = (BitmapCol*)scan0;
 	BitmapCol* baseDst = (BitmapCol*)lvlScan0;
-	int srcWidth = width << 1;
+	/* Once a dimension reaches 1, the same pixel is used twice */
+	int offsetX = srcWidth  > 1 ? 1 : 0;
+	int offsetY = srcHeight > 1 ? srcWidth : 0;
+	BitmapCol ave0, ave1, opaque;
 
 	int x, y;
 	for (y = 0; y < height; y++) {
 		int srcY = (y << 1);
 		BitmapCol* src0 = baseSrc + srcY * srcWidth;
-		BitmapCol* src1 = src0    + srcWidth;
+		BitmapCol* src1 = src0    + offsetY;
 		BitmapCol* dst  = baseDst + y * width;
 
 		for (x = 0; x < width; x++) {
 			int srcX = (x << 1);
-			BitmapCol src00 = src0[srcX], src01 = src0[srcX + 1];
-			BitmapCol src10 = src1[srcX], src11 = src1[srcX + 1];
+			BitmapCol src00 = src0[srcX], src01 = src0[srcX + offsetX];
+			BitmapCol src10 = src1[srcX], src11 = src1[srcX + offsetX];
+
+			/* most pixels are fully opaque, which doesn't need premultiplying */
+			opaque._raw = src00._raw & src01._raw & src10._raw & src11._raw;
+			if (opaque.A == 255) {
+				dst[x]._raw = Gfx_AverageOpaque(Gfx_AverageOpaque(src00._raw, src01._raw), 
+												Gfx_AverageOpaque(src10._raw, src11._raw));
+				continue;
+			}
 
 			/* bilinear filter this mipmap */
-			BitmapCol ave0 = Gfx_Average(src00, src01);
-			BitmapCol ave1 = Gfx_Average(src10, src11);
+			ave0 = Gfx_Average(src00, src01);
+			ave1 = Gfx_Average(src10, src11);
 			dst[x] = Gfx_Average(ave0, ave1);
 		}
 	}
@@ -471,18 +485,26 @@ static void D3D9_SetTexturePartData(IDirect3DTexture9* texture, int x, int y, Bi
 static void D3D9_DoMipmaps(IDirect3DTexture9* texture, int x, int y, Bitmap* bmp, bool partial) {
 	uint8_t* prev = bmp->Scan0;
 	uint8_t* cur;
+	uint8_t* buffer;
 	Bitmap mipmap;
 
 	int lvls = Gfx_MipmapsLevels(bmp->Width, bmp->Height);
 	int lvl, width = bmp->Width, height = bmp->Height;
+	int srcWidth, srcHeight;
+	uint32_t size;
+
+	/* Later levels are never bigger than the first, so just alternate between two buffers */
+	size   = Bitmap_DataSize(max(width >> 1, 1), max(height >> 1, 1));
+	buffer = (uint8_t*)Mem_Alloc(2, size, "mipmaps");
 
 	for (lvl = 1; lvl <= lvls; lvl++) {
 		x /= 2; y /= 2;
+		srcWidth = width; srcHeight = height;
 		if (width > 1)   width /= 2;
 		if (height > 1) height /= 2;
 
-		cur = (uint8_t*)Mem_Alloc(width * height, 4, "mipmaps");
-		Gfx_GenMipmaps(width, height, cur, prev);
+		cur = buffer + ((lvl & 1) ? 0 : size);
+		Gfx_GenMipmaps(width, height, cur, prev, srcWidth, srcHeight);
 
 		Bitmap_Init(mipmap, width, height, cur);
 		if (partial) {
@@ -490,11 +512,9 @@ static void D3D9_DoMipmaps(IDirect3DTexture9* texture, int x, int y, Bitmap* bmp
 		} else {
 			D3D9_SetTextureData(texture, &mipmap, lvl);
 		}
-
-		if (prev != bmp->Scan0) Mem_Free(prev);
 		prev = cur;
 	}
-	if (prev != bmp->Scan0) Mem_Free(prev);
+	Mem_Free(buffer);
 }
 
 GfxResourceID Gfx_CreateTexture(Bitmap* bmp, bool managedPool, bool mipmaps) {
@@ -1040,28 +1060,34 @@ void Gfx_Free(void) {
 static void Gfx_DoMipmaps(int x, int y, Bitmap* bmp, bool partial) {
 	uint8_t* prev = bmp->Scan0;
 	uint8_t* cur;
+	uint8_t* buffer;
 
 	int lvls = Gfx_MipmapsLevels(bmp->Width, bmp->Height);
 	int lvl, width = bmp->Width, height = bmp->Height;
+	int srcWidth, srcHeight;
+	uint32_t size;
+
+	/* Later levels are never bigger than the first, so just alternate between two buffers */
+	size   = Bitmap_DataSize(max(width >> 1, 1), max(height >> 1, 1));
+	buffer = (uint8_t*)Mem_Alloc(2, size, "mipmaps");
 
 	for (lvl = 1; lvl <= lvls; lvl++) {
 		x /= 2; y /= 2;
+		srcWidth = width; srcHeight = height;
 		if (width > 1)  width /= 2;
 		if (height > 1) height /= 2;
 
-		cur = (uint8_t*)Mem_Alloc(width * height, 4, "mipmaps");
-		Gfx_GenMipmaps(width, height, cur, prev);
+		cur = buffer + ((lvl & 1) ? 0 : size);
+		Gfx_GenMipmaps(width, height, cur, prev, srcWidth, srcHeight);
 
 		if (partial) {
 			glTexSubImage2D(GL_TEXTURE_2D, lvl, x, y, width, height, PIXEL_FORMAT, GL_UNSIGNED_BYTE, cur);
 		} else {
 			glTexImage2D(GL_TEXTURE_2D, lvl, GL_RGBA, width, height, 0, PIXEL_FORMAT, GL_UNSIGNED_BYTE, cur);
 		}
-
-		if (prev != bmp->Scan0) Mem_Free(prev);
 		prev = cur;
 	}
-	if (prev != bmp->Scan0) Mem_Free(prev);
+	Mem_Free(buffer);
 }
 
 GfxResourceID Gfx_CreateTexture(Bitmap* bmp, bool managedPool, bool mipmaps) {
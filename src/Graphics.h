@@ -190,7 +190,8 @@ void Gfx_SetupAlphaState(uint8_t draw);
 /* Undoes changes to alpha test/blending state by Gfx_SetupAlphaState. */
 void Gfx_RestoreAlphaState(uint8_t draw);
 /* Generates the next mipmaps level bitmap for the given bitmap. */
-void Gfx_GenMipmaps(int width, int height, uint8_t* lvlScan0, uint8_t* scan0);
+/* NOTE: srcWidth/srcHeight are the dimensions of scan0, which may be 1 in only one dimension. */
+void Gfx_GenMipmaps(int width, int height, uint8_t* lvlScan0, uint8_t* scan0, int srcWidth, int srcHeight);
 /* Returns the maximum number of mipmaps levels used for given size. */
 int Gfx_MipmapsLevels(int width, int height);
 
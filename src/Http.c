@@ -4,6 +4,7 @@
 #include "Logger.h"
 #include "Stream.h"
 #include "GameStructs.h"
+#include "Options.h"
 
 #if defined CC_BUILD_WININET
 #define WIN32_LEAN_AND_MEAN
@@ -60,18 +61,6 @@ static void RequestList_Append(struct RequestList* list, struct HttpRequest* ite
 	list->Entries[list->Count++] = *item;
 }
 
-/* Inserts a request at start (for high priority request) */
-static void RequestList_Prepend(struct RequestList* list, struct HttpRequest* item) {
-	int i;
-	RequestList_EnsureSpace(list);
-	
-	for (i = list->Count; i > 0; i--) {
-		list->Entries[i] = list->Entries[i - 1];
-	}
-	list->Entries[0] = *item;
-	list->Count++;
-}
-
 /* Removes the request at the given index */
 static void RequestList_RemoveAt(struct RequestList* list, int i) {
 	if (i < 0 || i >= list->Count) Logger_Abort("Tried to remove element at list end");
@@ -82,21 +71,6 @@ static void RequestList_RemoveAt(struct RequestList* list, int i) {
 	list->Count--;
 }
 
-/* Finds index of request whose id matches the given id */
-static int RequestList_Find(struct RequestList* list, const String* id, struct HttpRequest* item) {
-	String reqID;
-	int i;
-
-	for (i = 0; i < list->Count; i++) {
-		reqID = String_FromRawArray(list->Entries[i].ID);
-		if (!String_Equals(id, &reqID)) continue;
-
-		*item = list->Entries[i];
-		return i;
-	}
-	return -1;
-}
-
 /* Resets state to default */
 static void RequestList_Init(struct RequestList* list) {
 	list->Capacity = HTTP_DEF_ELEMS;
@@ -111,20 +85,144 @@ static void RequestList_Free(struct RequestList* list) {
 }
 
 
+/*########################################################################################################################*
+*-----------------------------------------------------Http results--------------------------------------------------------*
+*#########################################################################################################################*/
+/* Completed requests are moved into this table by the main thread, and are indexed by */
+/* a hash of their ID. So polling for a result every frame doesn't need to search every request. */
+#define HTTP_RESULT_BUCKETS 64
+struct HttpResult { struct HttpRequest Req; uint32_t Hash; int Next; };
+static struct HttpResult* http_results;
+static int http_resultsCount, http_resultsCapacity;
+static int http_resultBuckets[HTTP_RESULT_BUCKETS];
+
+static uint32_t HttpResults_Hash(const String* id) {
+	return Utils_CRC32((const uint8_t*)id->buffer, id->length);
+}
+
+/* Finds index of the result whose id matches the given id */
+static int HttpResults_Find(const String* id, uint32_t hash) {
+	String reqID;
+	int i = http_resultBuckets[hash % HTTP_RESULT_BUCKETS];
+
+	for (; i >= 0; i = http_results[i].Next) {
+		if (http_results[i].Hash != hash) continue;
+		reqID = String_FromRawArray(http_results[i].Req.ID);
+		if (String_Equals(id, &reqID)) return i;
+	}
+	return -1;
+}
+
+static void HttpResults_Link(int i) {
+	int bucket = http_results[i].Hash % HTTP_RESULT_BUCKETS;
+	http_results[i].Next       = http_resultBuckets[bucket];
+	http_resultBuckets[bucket] = i;
+}
+
+static void HttpResults_Unlink(int i) {
+	int* link = &http_resultBuckets[http_results[i].Hash % HTTP_RESULT_BUCKETS];
+	while (*link != i) { link = &http_results[*link].Next; }
+	*link = http_results[i].Next;
+}
+
+/* Removes the result at the given index, moving the last result into its place */
+static void HttpResults_RemoveAt(int i) {
+	int last = http_resultsCount - 1;
+	HttpResults_Unlink(i);
+
+	if (i != last) {
+		HttpResults_Unlink(last);
+		http_results[i] = http_results[last];
+		HttpResults_Link(i);
+	}
+	http_resultsCount--;
+}
+
+static void HttpResults_Add(struct HttpRequest* req) {
+	String id     = String_FromRawArray(req->ID);
+	uint32_t hash = HttpResults_Hash(&id);
+	struct HttpRequest* older;
+	int i = HttpResults_Find(&id, hash);
+
+	if (i >= 0) {
+		/* very rare case - same request was added twice, and both got downloaded */
+		/* before an external function removed the first one from the results */
+		older = &http_results[i].Req;
+		if (older->TimeAdded > req->TimeAdded) {
+			HttpRequest_Free(req);
+		} else {
+			/* normal case, replace older req */
+			HttpRequest_Free(older);
+			*older = *req;
+		}
+		return;
+	}
+
+	if (http_resultsCount == http_resultsCapacity) {
+		Utils_Resize((void**)&http_results, &http_resultsCapacity,
+					sizeof(struct HttpResult), 0, 16);
+	}
+	i = http_resultsCount++;
+	http_results[i].Req  = *req;
+	http_results[i].Hash = hash;
+	HttpResults_Link(i);
+}
+
+static void HttpResults_Init(void) {
+	int i;
+	for (i = 0; i < HTTP_RESULT_BUCKETS; i++) { http_resultBuckets[i] = -1; }
+}
+
+static void HttpResults_Free(void) {
+	int i;
+	for (i = 0; i < http_resultsCount; i++) {
+		HttpRequest_Free(&http_results[i].Req);
+	}
+
+	Mem_Free(http_results);
+	http_results         = NULL;
+	http_resultsCount    = 0;
+	http_resultsCapacity = 0;
+	HttpResults_Init();
+}
+
+
 /*########################################################################################################################*
 *--------------------------------------------------Common downloader code-------------------------------------------------*
 *#########################################################################################################################*/
 static void* workerWaitable;
-static void* workerThread;
 static void* pendingMutex;
 static void* processedMutex;
 static void* curRequestMutex;
 static volatile bool http_terminate;
 
-static struct RequestList pendingReqs;
-static struct RequestList processedReqs;
-static struct HttpRequest http_curRequest;
-static volatile int http_curProgress = ASYNC_PROGRESS_NOTHING;
+static struct RequestList pendingReqs;  /* normal priority requests (e.g. skins) */
+static struct RequestList priorityReqs; /* high priority requests (e.g. texture packs) */
+/* Requests completed by workers, that haven't been moved into the results table yet */
+static struct RequestList completedReqs;
+static volatile int http_completedCount;
+
+/* Requests are processed by a pool of worker threads, each with its own backend state. */
+/* (so connections to a server can be kept alive and reused between requests) */
+#if defined CC_BUILD_ANDROID
+/* Java side can only process one request at a time */
+#define HTTP_MAX_WORKERS 1
+#else
+#define HTTP_MAX_WORKERS 8
+#endif
+#define HTTP_DEF_WORKERS 4
+
+struct HttpWorker {
+	int Index;
+	struct HttpRequest* Req;    /* Request currently being processed */
+	struct HttpRequest Current; /* Copy of the request being processed, for Http_GetCurrent */
+	volatile int Progress;      /* Download progress of the request being processed */
+	bool Priority;              /* Whether request being processed is from the high priority list */
+	uint32_t BufferSize;        /* Size of the buffer allocated for the response contents */
+	void* Thread;
+};
+static struct HttpWorker http_workers[HTTP_MAX_WORKERS];
+static int http_workersCount, http_workersStarted, http_priorityBusy;
 
 #ifdef CC_BUILD_WEB
 static void Http_DownloadNextAsync(void);
@@ -164,7 +262,7 @@ static void Http_Add(const String* url, bool priority, const String* id, uint8_t
 	{	
 		req.TimeAdded = DateTime_CurrentUTC_MS();
 		if (priority) {
-			RequestList_Prepend(&pendingReqs, &req);
+			RequestList_Append(&priorityReqs, &req);
 		} else {
 			RequestList_Append(&pendingReqs,  &req);
 		}
@@ -179,78 +277,76 @@ static void Http_Add(const String* url, bool priority, const String* id, uint8_t
 }
 
 /* Sets up state to begin a http request */
-static void Http_BeginRequest(struct HttpRequest* req) {
+static void Http_BeginRequest(struct HttpWorker* w, struct HttpRequest* req) {
 	String url = String_FromRawArray(req->URL);
-	Platform_Log2("Downloading from %s (type %b)", &url, &req->RequestType);
+	Platform_Log3("Downloading from %s (type %b, worker %i)", &url, &req->RequestType, &w->Index);
+	w->Req = req;
 
 	Mutex_Lock(curRequestMutex);
 	{
-		http_curRequest  = *req;
-		http_curProgress = ASYNC_PROGRESS_MAKING_REQUEST;
+		w->Current  = *req;
+		w->Progress = ASYNC_PROGRESS_MAKING_REQUEST;
 	}
 	Mutex_Unlock(curRequestMutex);
 }
 
-/* Adds given request to list of processed/completed requests */
-static void Http_CompleteRequest(struct HttpRequest* req) {
-	struct HttpRequest older;
-	String id = String_FromRawArray(req->ID);
-	int index;
-	req->TimeDownloaded = DateTime_CurrentUTC_MS();
+/* Moves requests completed by the workers into the results table */
+/* NOTE: Must only be called from the main thread */
+static void Http_ProcessCompleted(void) {
+	int i;
+	/* avoid locking when there's nothing to do, which is almost always the case */
+	if (!http_completedCount) return;
 
-	index = RequestList_Find(&processedReqs, &id, &older);
-	if (index >= 0) {
-		/* very rare case - priority item was inserted, then inserted again (so put before first item), */
-		/* and both items got downloaded before an external function removed them from the queue */
-		if (older.TimeAdded > req->TimeAdded) {
-			HttpRequest_Free(req);
-		} else {
-			/* normal case, replace older req */
-			HttpRequest_Free(&older);
-			processedReqs.Entries[index] = *req;
+	Mutex_Lock(processedMutex);
+	{
+		for (i = 0; i < completedReqs.Count; i++) {
+			HttpResults_Add(&completedReqs.Entries[i]);
 		}
-	} else {
-		RequestList_Append(&processedReqs, req);
+		completedReqs.Count = 0;
+		http_completedCount = 0;
 	}
+	Mutex_Unlock(processedMutex);
 }
 
 /* Updates state after a completed http request */
-static void Http_FinishRequest(struct HttpRequest* req) {
+static void Http_FinishRequest(struct HttpWorker* w, struct HttpRequest* req) {
 	if (req->Data) Platform_Log1("HTTP returned data: %i bytes", &req->Size);
 	req->Success = !req->Result && req->StatusCode == 200 && req->Data && req->Size;
 	if (!req->Success) HttpRequest_Free(req);
 
+	req->TimeDownloaded = DateTime_CurrentUTC_MS();
 	Mutex_Lock(processedMutex);
 	{
-		Http_CompleteRequest(req);
+		RequestList_Append(&completedReqs, req);
+		http_completedCount = completedReqs.Count;
 	}
 	Mutex_Unlock(processedMutex);
 
 	Mutex_Lock(curRequestMutex);
 	{
-		http_curRequest.ID[0] = '\0';
-		http_curProgress = ASYNC_PROGRESS_NOTHING;
+		w->Current.ID[0] = '\0';
+		w->Progress = ASYNC_PROGRESS_NOTHING;
 	}
 	Mutex_Unlock(curRequestMutex);
+	w->Req = NULL;
 }
 
 /* Deletes cached responses that are over 10 seconds old */
 static void Http_CleanCacheTask(struct ScheduledTask* task) {
 	struct HttpRequest* item;
+	TimeMS now;
 	int i;
 
-	Mutex_Lock(processedMutex);
-	{
-		TimeMS now = DateTime_CurrentUTC_MS();
-		for (i = processedReqs.Count - 1; i >= 0; i--) {
-			item = &processedReqs.Entries[i];
-			if (item->TimeDownloaded + (10 * 1000) >= now) continue;
+	Http_ProcessCompleted();
+	now = DateTime_CurrentUTC_MS();
 
-			HttpRequest_Free(item);
-			RequestList_RemoveAt(&processedReqs, i);
-		}
+	for (i = http_resultsCount - 1; i >= 0; i--) {
+		item = &http_results[i].Req;
+		if (item->TimeDownloaded + (10 * 1000) >= now) continue;
+
+		HttpRequest_Free(item);
+		HttpResults_RemoveAt(i);
 	}
-	Mutex_Unlock(processedMutex);
 }
 
 static void Http_ParseCookie(struct HttpRequest* req, const String* value) {
@@ -292,24 +388,25 @@ static void Http_ParseHeader(struct HttpRequest* req, const String* line) {
 }
 
 /* Adds a http header to the request headers. */
-static void Http_AddHeader(const char* key, const String* value);
+static void Http_AddHeader(struct HttpWorker* w, const char* key, const String* value);
 
 /* Adds all the appropriate headers for a request. */
-static void Http_SetRequestHeaders(struct HttpRequest* req) {
+static void Http_SetRequestHeaders(struct HttpWorker* w) {
 	static const String contentType = String_FromConst("application/x-www-form-urlencoded");
+	struct HttpRequest* req = w->Req;
 	String str, cookies; char cookiesBuffer[1024];
 	int i;
 
 	if (req->LastModified[0]) {
 		str = String_FromRawArray(req->LastModified);
-		Http_AddHeader("If-Modified-Since", &str);
+		Http_AddHeader(w, "If-Modified-Since", &str);
 	}
 	if (req->Etag[0]) {
 		str = String_FromRawArray(req->Etag);
-		Http_AddHeader("If-None-Match", &str);
+		Http_AddHeader(w, "If-None-Match", &str);
 	}
 
-	if (req->Data) Http_AddHeader("Content-Type", &contentType);
+	if (req->Data) Http_AddHeader(w, "Content-Type", &contentType);
 	if (!req->Cookies || !req->Cookies->entries.count) return;
 
 	String_InitArray(cookies, cookiesBuffer);
@@ -318,7 +415,7 @@ static void Http_SetRequestHeaders(struct HttpRequest* req) {
 		str = StringsBuffer_UNSAFE_Get(&req->Cookies->entries, i);
 		String_AppendString(&cookies, &str);
 	}
-	Http_AddHeader("Cookie", &cookies);
+	Http_AddHeader(w, "Cookie", &cookies);
 }
 
 
@@ -327,39 +424,54 @@ static void Http_SetRequestHeaders(struct HttpRequest* req) {
 *#########################################################################################################################*/
 #if defined CC_BUILD_WEB
 static void Http_SysInit(void) { }
+static void Http_SysInitWorker(struct HttpWorker* w) { }
 static void Http_SysFree(void) { }
 static void Http_DownloadAsync(struct HttpRequest* req);
 bool Http_DescribeError(ReturnCode res, String* dst) { return false; }
-static void Http_AddHeader(const char* key, const String* value);
+static void Http_AddHeader(struct HttpWorker* w, const char* key, const String* value);
 
+/* Only one request is processed at a time, using the first worker's state */
 static void Http_DownloadNextAsync(void) {
+	struct RequestList* list;
 	struct HttpRequest req;
-	if (http_terminate || !pendingReqs.Count) return;
+	if (http_terminate) return;
 	/* already working on a request currently */
-	if (http_curRequest.ID[0] != '\0') return;
+	if (http_workers[0].Current.ID[0] != '\0') return;
+
+	list = priorityReqs.Count ? &priorityReqs : &pendingReqs;
+	if (!list->Count) return;
 
-	req = pendingReqs.Entries[0];
-	RequestList_RemoveAt(&pendingReqs, 0);
+	req = list->Entries[0];
+	RequestList_RemoveAt(list, 0);
 	Http_DownloadAsync(&req);
 }
 
 static void Http_UpdateProgress(emscripten_fetch_t* fetch) {
 	if (!fetch->totalBytes) return;
-	http_curProgress = (int)(100.0f * fetch->dataOffset / fetch->totalBytes);
+	http_workers[0].Progress = (int)(100.0f * fetch->dataOffset / fetch->totalBytes);
 }
 
 static void Http_FinishedAsync(emscripten_fetch_t* fetch) {
-	struct HttpRequest* req = &http_curRequest;
-	req->Data          = fetch->data;
+	struct HttpRequest* req = &http_workers[0].Current;
 	req->Size          = fetch->numBytes;
 	req->StatusCode    = fetch->status;
 	req->ContentLength = fetch->totalBytes;
 
+#ifdef CC_BUILD_MEMTRACK
+	/* Data is freed with Mem_Free, which expects the header Mem_Alloc puts in front of tracked memory */
+	req->Data = NULL;
+	if (fetch->data && req->Size) {
+		req->Data = (uint8_t*)Mem_Alloc(req->Size, 1, "HTTP data");
+		Mem_Copy(req->Data, fetch->data, req->Size);
+	}
+#else
 	/* data needs to persist beyond closing of fetch data */
+	req->Data   = fetch->data;
 	fetch->data = NULL;
+#endif
 	emscripten_fetch_close(fetch);
 
-	Http_FinishRequest(&http_curRequest);
+	Http_FinishRequest(&http_workers[0], req);
 	Http_DownloadNextAsync();
 }
 
@@ -390,7 +502,7 @@ static void Http_DownloadAsync(struct HttpRequest* req) {
 	attr.onerror    = Http_FinishedAsync;
 	attr.onprogress = Http_UpdateProgress;
 
-	Http_BeginRequest(req);
+	Http_BeginRequest(&http_workers[0], req);
 	/* TODO: SET requestHeaders!!! */
 	emscripten_fetch(&attr, urlStr);
 }
@@ -400,29 +512,30 @@ static void Http_DownloadAsync(struct HttpRequest* req) {
 /*########################################################################################################################*
 *--------------------------------------------------Native implementation--------------------------------------------------*
 *#########################################################################################################################*/
-static uint32_t bufferSize;
-
 /* Allocates initial data buffer to store response contents */
-static void Http_BufferInit(struct HttpRequest* req) {
-	http_curProgress = 0;
-	bufferSize = req->ContentLength ? req->ContentLength : 1;
-	req->Data  = (uint8_t*)Mem_Alloc(bufferSize, 1, "http get data");
-	req->Size  = 0;
+static void Http_BufferInit(struct HttpWorker* w) {
+	struct HttpRequest* req = w->Req;
+	w->Progress   = 0;
+	w->BufferSize = req->ContentLength ? req->ContentLength : 1;
+	req->Data     = (uint8_t*)Mem_Alloc(w->BufferSize, 1, "http get data");
+	req->Size     = 0;
 }
 
 /* Ensures data buffer has enough space left to append amount bytes, reallocates if not */
-static void Http_BufferEnsure(struct HttpRequest* req, uint32_t amount) {
+static void Http_BufferEnsure(struct HttpWorker* w, uint32_t amount) {
+	struct HttpRequest* req = w->Req;
 	uint32_t newSize = req->Size + amount;
-	if (newSize <= bufferSize) return;
+	if (newSize <= w->BufferSize) return;
 
-	bufferSize = newSize;
-	req->Data  = (uint8_t*)Mem_Realloc(req->Data, newSize, 1, "http inc data");
+	w->BufferSize = newSize;
+	req->Data     = (uint8_t*)Mem_Realloc(req->Data, newSize, 1, "http inc data");
 }
 
 /* Increases size and updates current progress */
-static void Http_BufferExpanded(struct HttpRequest* req, uint32_t read) {
+static void Http_BufferExpanded(struct HttpWorker* w, uint32_t read) {
+	struct HttpRequest* req = w->Req;
 	req->Size += read;
-	if (req->ContentLength) http_curProgress = (int)(100.0f * req->Size / req->ContentLength);
+	if (req->ContentLength) w->Progress = (int)(100.0f * req->Size / req->ContentLength);
 }
 
 #if defined CC_BUILD_WININET
@@ -437,7 +550,8 @@ struct HttpCacheEntry {
 	char _addressBuffer[STRING_SIZE + 1];
 };
 #define HTTP_CACHE_ENTRIES 10
-static struct HttpCacheEntry http_cache[HTTP_CACHE_ENTRIES];
+/* Each worker has its own cache, so one worker never closes a connection another is using */
+static struct HttpCacheEntry http_cache[HTTP_MAX_WORKERS][HTTP_CACHE_ENTRIES];
 
 /* Splits up the components of a URL */
 static void HttpCache_MakeEntry(const String* url, struct HttpCacheEntry* entry, String* resource) {
@@ -464,27 +578,27 @@ static void HttpCache_MakeEntry(const String* url, struct HttpCacheEntry* entry,
 }
 
 /* Inserts entry into the cache at the given index */
-static ReturnCode HttpCache_Insert(int i, struct HttpCacheEntry* e) {
+static ReturnCode HttpCache_Insert(struct HttpCacheEntry* cache, int i, struct HttpCacheEntry* e) {
 	HINTERNET conn;
 	conn = InternetConnectA(hInternet, e->Address.buffer, e->Port, NULL, NULL, 
 				INTERNET_SERVICE_HTTP, e->Https ? INTERNET_FLAG_SECURE : 0, 0);
 	if (!conn) return GetLastError();
 
-	e->Handle     = conn;
-	http_cache[i] = *e;
+	e->Handle = conn;
+	cache[i]  = *e;
 
 	/* otherwise address buffer points to stack buffer */
-	http_cache[i].Address.buffer = http_cache[i]._addressBuffer;
+	cache[i].Address.buffer = cache[i]._addressBuffer;
 	return 0;
 }
 
 /* Finds or inserts the given entry into the cache */
-static ReturnCode HttpCache_Lookup(struct HttpCacheEntry* e) {
+static ReturnCode HttpCache_Lookup(struct HttpCacheEntry* cache, struct HttpCacheEntry* e) {
 	struct HttpCacheEntry* c;
 	int i;
 
 	for (i = 0; i < HTTP_CACHE_ENTRIES; i++) {
-		c = &http_cache[i];
+		c = &cache[i];
 		if (c->Https == e->Https && String_Equals(&c->Address, &e->Address) && c->Port == e->Port) {
 			e->Handle = c->Handle;
 			return 0;
@@ -492,14 +606,14 @@ static ReturnCode HttpCache_Lookup(struct HttpCacheEntry* e) {
 	}
 
 	for (i = 0; i < HTTP_CACHE_ENTRIES; i++) {
-		if (http_cache[i].Handle) continue;
-		return HttpCache_Insert(i, e);
+		if (cache[i].Handle) continue;
+		return HttpCache_Insert(cache, i, e);
 	}
 
 	/* TODO: Should we be consistent in which entry gets evicted? */
 	i = (uint8_t)Stopwatch_Measure() % HTTP_CACHE_ENTRIES;
-	InternetCloseHandle(http_cache[i].Handle);
-	return HttpCache_Insert(i, e);
+	InternetCloseHandle(cache[i].Handle);
+	return HttpCache_Insert(cache, i, e);
 }
 
 bool Http_DescribeError(ReturnCode res, String* dst) {
@@ -518,18 +632,19 @@ static void Http_SysInit(void) {
 	if (!hInternet) Logger_Abort2(GetLastError(), "Failed to init WinINet");
 }
 
-static HINTERNET curReq;
-static void Http_AddHeader(const char* key, const String* value) {
+static HINTERNET curReqs[HTTP_MAX_WORKERS];
+static void Http_AddHeader(struct HttpWorker* w, const char* key, const String* value) {
 	String tmp; char tmpBuffer[1024];
 	String_InitArray(tmp, tmpBuffer);
 
 	String_Format2(&tmp, "%c: %s\r\n", key, value);
-	HttpAddRequestHeadersA(curReq, tmp.buffer, tmp.length, HTTP_ADDREQ_FLAG_ADD | HTTP_ADDREQ_FLAG_REPLACE);
+	HttpAddRequestHeadersA(curReqs[w->Index], tmp.buffer, tmp.length, HTTP_ADDREQ_FLAG_ADD | HTTP_ADDREQ_FLAG_REPLACE);
 }
 
 /* Creates and sends a HTTP requst */
-static ReturnCode Http_StartRequest(struct HttpRequest* req, HINTERNET* handle) {
+static ReturnCode Http_StartRequest(struct HttpWorker* w, HINTERNET* handle) {
 	static const char* verbs[3] = { "GET", "HEAD", "POST" };
+	struct HttpRequest* req = w->Req;
 	struct HttpCacheEntry entry;
 	DWORD flags;
 
@@ -539,17 +654,17 @@ static ReturnCode Http_StartRequest(struct HttpRequest* req, HINTERNET* handle)
 	HttpCache_MakeEntry(&url, &entry, &path);
 	Mem_Copy(pathBuffer, path.buffer, path.length);
 	pathBuffer[path.length] = '\0';
-	HttpCache_Lookup(&entry);
+	HttpCache_Lookup(http_cache[w->Index], &entry);
 
 	flags = INTERNET_FLAG_NO_CACHE_WRITE | INTERNET_FLAG_NO_UI | INTERNET_FLAG_RELOAD | INTERNET_FLAG_NO_COOKIES;
 	if (entry.Https) flags |= INTERNET_FLAG_SECURE;
 
 	*handle = HttpOpenRequestA(entry.Handle, verbs[req->RequestType], 
 								pathBuffer, NULL, NULL, NULL, flags, 0);
-	curReq  = *handle;
-	if (!curReq) return GetLastError();
+	curReqs[w->Index] = *handle;
+	if (!*handle) return GetLastError();
 
-	Http_SetRequestHeaders(req);
+	Http_SetRequestHeaders(w);
 	return HttpSendRequestA(*handle, NULL, 0, req->Data, req->Size) ? 0 : GetLastError();
 }
 
@@ -569,52 +684,62 @@ static ReturnCode Http_ProcessHeaders(struct HttpRequest* req, HINTERNET handle)
 }
 
 /* Downloads the data/contents of a HTTP response */
-static ReturnCode Http_DownloadData(struct HttpRequest* req, HINTERNET handle) {
+static ReturnCode Http_DownloadData(struct HttpWorker* w, HINTERNET handle) {
+	struct HttpRequest* req = w->Req;
 	DWORD read, avail;
-	Http_BufferInit(req);
+	Http_BufferInit(w);
 
 	for (;;) {
 		if (!InternetQueryDataAvailable(handle, &avail, 0, 0)) break;
 		if (!avail) break;
-		Http_BufferEnsure(req, avail);
+		Http_BufferEnsure(w, avail);
 
 		if (!InternetReadFile(handle, &req->Data[req->Size], avail, &read)) return GetLastError();
 		if (!read) break;
-		Http_BufferExpanded(req, read);
+		Http_BufferExpanded(w, read);
 	}
 
- 	http_curProgress = 100;
+ 	w->Progress = 100;
 	return 0;
 }
 
-static ReturnCode Http_SysDo(struct HttpRequest* req) {
+static ReturnCode Http_SysDo(struct HttpWorker* w) {
+	struct HttpRequest* req = w->Req;
 	HINTERNET handle;
-	ReturnCode res = Http_StartRequest(req, &handle);
+	ReturnCode res = Http_StartRequest(w, &handle);
 	HttpRequest_Free(req);
 	if (res) return res;
 
-	http_curProgress = ASYNC_PROGRESS_FETCHING_DATA;
+	w->Progress = ASYNC_PROGRESS_FETCHING_DATA;
 	res = Http_ProcessHeaders(req, handle);
 	if (res) { InternetCloseHandle(handle); return res; }
 
 	if (req->RequestType != REQUEST_TYPE_HEAD) {
-		res = Http_DownloadData(req, handle);
+		res = Http_DownloadData(w, handle);
 		if (res) { InternetCloseHandle(handle); return res; }
 	}
 
 	return InternetCloseHandle(handle) ? 0 : GetLastError();
 }
 
+static void Http_SysInitWorker(struct HttpWorker* w) { }
+
 static void Http_SysFree(void) {
-	int i;
-	for (i = 0; i < HTTP_CACHE_ENTRIES; i++) {
-		if (!http_cache[i].Handle) continue;
-		InternetCloseHandle(http_cache[i].Handle);
+	int i, j;
+	for (i = 0; i < HTTP_MAX_WORKERS; i++) {
+		for (j = 0; j < HTTP_CACHE_ENTRIES; j++) {
+			if (!http_cache[i][j].Handle) continue;
+			InternetCloseHandle(http_cache[i][j].Handle);
+		}
 	}
 	InternetCloseHandle(hInternet);
 }
 #elif defined CC_BUILD_CURL
-static CURL* curl;
+static CURL* curl_handles[HTTP_MAX_WORKERS];
+static struct curl_slist* curl_headers[HTTP_MAX_WORKERS];
+/* DNS cache, SSL sessions and open connections are shared between all the workers */
+static CURLSH* curl_share;
+static void* curl_locks[CURL_LOCK_DATA_LAST];
 
 bool Http_DescribeError(ReturnCode res, String* dst) {
 	const char* err = curl_easy_strerror(res);
@@ -624,22 +749,44 @@ bool Http_DescribeError(ReturnCode res, String* dst) {
 	return true;
 }
 
+static void Http_LockShare(CURL* handle, curl_lock_data data, curl_lock_access access, void* obj) {
+	Mutex_Lock(curl_locks[data]);
+}
+static void Http_UnlockShare(CURL* handle, curl_lock_data data, void* obj) {
+	Mutex_Unlock(curl_locks[data]);
+}
+
 static void Http_SysInit(void) {
 	CURLcode res = curl_global_init(CURL_GLOBAL_DEFAULT);
+	int i;
 	if (res) Logger_Abort2(res, "Failed to init curl");
 
-	curl = curl_easy_init();
-	if (!curl) Logger_Abort("Failed to init easy curl");
+	curl_share = curl_share_init();
+	if (!curl_share) Logger_Abort("Failed to init curl share");
+	for (i = 0; i < CURL_LOCK_DATA_LAST; i++) { curl_locks[i] = Mutex_Create(); }
+
+	curl_share_setopt(curl_share, CURLSHOPT_LOCKFUNC,   Http_LockShare);
+	curl_share_setopt(curl_share, CURLSHOPT_UNLOCKFUNC, Http_UnlockShare);
+	curl_share_setopt(curl_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+	curl_share_setopt(curl_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+	/* Only supported in curl 7.57 and later */
+	curl_share_setopt(curl_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+}
+
+static void Http_SysInitWorker(struct HttpWorker* w) {
+	curl_handles[w->Index] = curl_easy_init();
+	if (!curl_handles[w->Index]) Logger_Abort("Failed to init easy curl");
 }
 
-static struct curl_slist* headers_list;
-static void Http_AddHeader(const char* key, const String* value) {
+static void Http_AddHeader(struct HttpWorker* w, const char* key, const String* value) {
 	String tmp; char tmpBuffer[1024];
 	String_InitArray_NT(tmp, tmpBuffer);
 	String_Format2(&tmp, "%c: %s", key, value);
 
 	tmp.buffer[tmp.length] = '\0';
-	headers_list = curl_slist_append(headers_list, tmp.buffer);
+	curl_headers[w->Index] = curl_slist_append(curl_headers[w->Index], tmp.buffer);
 }
 
 /* Processes a HTTP header downloaded from the server */
@@ -657,39 +804,44 @@ static size_t Http_ProcessHeader(char *buffer, size_t size, size_t nitems, void*
 
 /* Processes a chunk of data downloaded from the web server */
 static size_t Http_ProcessData(char *buffer, size_t size, size_t nitems, void* userdata) {
-	struct HttpRequest* req = (struct HttpRequest*)userdata;
+	struct HttpWorker* w    = (struct HttpWorker*)userdata;
+	struct HttpRequest* req = w->Req;
 
-	if (!bufferSize) Http_BufferInit(req);
-	Http_BufferEnsure(req, nitems);
+	if (!w->BufferSize) Http_BufferInit(w);
+	Http_BufferEnsure(w, nitems);
 
 	Mem_Copy(&req->Data[req->Size], buffer, nitems);
-	Http_BufferExpanded(req, nitems);
+	Http_BufferExpanded(w, nitems);
 	return nitems;
 }
 
 /* Sets general curl options for a request */
-static void Http_SetCurlOpts(struct HttpRequest* req) {
+static void Http_SetCurlOpts(struct HttpWorker* w, CURL* curl) {
 	curl_easy_setopt(curl, CURLOPT_USERAGENT,      GAME_APP_NAME);
 	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+	curl_easy_setopt(curl, CURLOPT_SHARE,          curl_share);
 
 	curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, Http_ProcessHeader);
-	curl_easy_setopt(curl, CURLOPT_HEADERDATA,     req);
+	curl_easy_setopt(curl, CURLOPT_HEADERDATA,     w->Req);
 	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION,  Http_ProcessData);
-	curl_easy_setopt(curl, CURLOPT_WRITEDATA,      req);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA,      w);
 }
 
-static ReturnCode Http_SysDo(struct HttpRequest* req) {
+static ReturnCode Http_SysDo(struct HttpWorker* w) {
+	struct HttpRequest* req = w->Req;
+	CURL* curl = curl_handles[w->Index];
 	String url = String_FromRawArray(req->URL);
 	char urlStr[600];
 	void* post_data = req->Data;
 	CURLcode res;
 
+	/* NOTE: Resetting keeps the connections this handle has open */
 	curl_easy_reset(curl);
-	headers_list = NULL;
-	Http_SetRequestHeaders(req);
-	curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers_list);
+	curl_headers[w->Index] = NULL;
+	Http_SetRequestHeaders(w);
+	curl_easy_setopt(curl, CURLOPT_HTTPHEADER, curl_headers[w->Index]);
 
-	Http_SetCurlOpts(req);
+	Http_SetCurlOpts(w, curl);
 	Platform_ConvertString(urlStr, &url);
 	curl_easy_setopt(curl, CURLOPT_URL, urlStr);
 
@@ -705,23 +857,30 @@ static ReturnCode Http_SysDo(struct HttpRequest* req) {
 		HttpRequest_Free(req);
 	}
 
-	bufferSize = 0;
-	http_curProgress = ASYNC_PROGRESS_FETCHING_DATA;
+	w->BufferSize = 0;
+	w->Progress   = ASYNC_PROGRESS_FETCHING_DATA;
 	res = curl_easy_perform(curl);
-	http_curProgress = 100;
+	w->Progress   = 100;
 
-	curl_slist_free_all(headers_list);
+	curl_slist_free_all(curl_headers[w->Index]);
 	/* can free now that request has finished */
 	Mem_Free(post_data);
 	return res;
 }
 
 static void Http_SysFree(void) {
-	curl_easy_cleanup(curl);
+	int i;
+	for (i = 0; i < HTTP_MAX_WORKERS; i++) {
+		if (curl_handles[i]) curl_easy_cleanup(curl_handles[i]);
+		curl_handles[i] = NULL;
+	}
+
+	curl_share_cleanup(curl_share);
+	for (i = 0; i < CURL_LOCK_DATA_LAST; i++) { Mutex_Free(curl_locks[i]); }
 	curl_global_cleanup();
 }
 #elif defined CC_BUILD_ANDROID
-struct HttpRequest* java_req;
+static struct HttpWorker* java_worker;
 
 bool Http_DescribeError(ReturnCode res, String* dst) {
 	String err;
@@ -741,7 +900,7 @@ bool Http_DescribeError(ReturnCode res, String* dst) {
 	return true;
 }
 
-static void Http_AddHeader(const char* key, const String* value) {
+static void Http_AddHeader(struct HttpWorker* w, const char* key, const String* value) {
 	JNIEnv* env;
 	jvalue args[2];
 
@@ -758,18 +917,19 @@ static void Http_AddHeader(const char* key, const String* value) {
 static void JNICALL java_HttpParseHeader(JNIEnv* env, jobject o, jstring header) {
 	String line = JavaGetString(env, header);
 	Platform_Log(&line);
-	Http_ParseHeader(java_req, &line);
+	Http_ParseHeader(java_worker->Req, &line);
 	(*env)->ReleaseStringUTFChars(env, header, line.buffer);
 }
 
 /* Processes a chunk of data downloaded from the web server */
 static void JNICALL java_HttpAppendData(JNIEnv* env, jobject o, jbyteArray arr, jint len) {
-	struct HttpRequest* req = java_req;
-	if (!bufferSize) Http_BufferInit(req);
+	struct HttpWorker* w    = java_worker;
+	struct HttpRequest* req = w->Req;
+	if (!w->BufferSize) Http_BufferInit(w);
 
-	Http_BufferEnsure(req, len);
+	Http_BufferEnsure(w, len);
 	(*env)->GetByteArrayRegion(env, arr, 0, len, &req->Data[req->Size]);
-	Http_BufferExpanded(req, len);
+	Http_BufferExpanded(w, len);
 }
 
 static const JNINativeMethod methods[2] = {
@@ -808,67 +968,105 @@ static ReturnCode Http_SetData(JNIEnv* env, struct HttpRequest* req) {
 	return res;
 }
 
-static ReturnCode Http_SysDo(struct HttpRequest* req) {
+static ReturnCode Http_SysDo(struct HttpWorker* w) {
 	static const String userAgent = String_FromConst(GAME_APP_NAME);
+	struct HttpRequest* req = w->Req;
 	JNIEnv* env;
 	jint res;
 
 	JavaGetCurrentEnv(env);
 	if ((res = Http_InitReq(env, req))) return res;
-	java_req = req;
+	java_worker = w;
 
-	Http_SetRequestHeaders(req);
-	Http_AddHeader("User-Agent", &userAgent);
+	Http_SetRequestHeaders(w);
+	Http_AddHeader(w, "User-Agent", &userAgent);
 	if (req->Data && (res = Http_SetData(env, req))) return res;
 
-	bufferSize = 0;
-	http_curProgress = ASYNC_PROGRESS_FETCHING_DATA;
+	w->BufferSize = 0;
+	w->Progress   = ASYNC_PROGRESS_FETCHING_DATA;
 	res = JavaCallInt(env, "httpPerform", "()I", NULL);
-	http_curProgress = 100;
+	w->Progress   = 100;
 	return res;
 }
 
+static void Http_SysInitWorker(struct HttpWorker* w) { }
 static void Http_SysFree(void) { }
 #endif
 
 #ifndef CC_BUILD_WEB
+/* Whether a high priority request can be started. At least one worker is always left */
+/* for normal priority requests, so e.g. a big texture pack download can't hold up skins. */
+static bool Http_CanTakePriority(void) {
+	return priorityReqs.Count && (http_workersCount == 1 || http_priorityBusy < http_workersCount - 1);
+}
+
+/* Removes the next request to process from the pending lists */
+static bool Http_TakeRequest(struct HttpWorker* w, struct HttpRequest* req) {
+	struct RequestList* list;
+
+	if (Http_CanTakePriority()) {
+		list = &priorityReqs;
+	} else if (pendingReqs.Count) {
+		list = &pendingReqs;
+	} else {
+		return false;
+	}
+
+	*req = list->Entries[0];
+	RequestList_RemoveAt(list, 0);
+
+	w->Priority = list == &priorityReqs;
+	if (w->Priority) http_priorityBusy++;
+	return true;
+}
+
 static void Http_WorkerLoop(void) {
 	struct HttpRequest request;
-	bool hasRequest, stop;
+	struct HttpWorker* w;
+	bool hasRequest, hasMore, stop;
 	uint64_t beg, end;
 	uint32_t elapsed;
 
+	Mutex_Lock(pendingMutex);
+	{
+		w = &http_workers[http_workersStarted++];
+	}
+	Mutex_Unlock(pendingMutex);
+
 	for (;;) {
 		hasRequest = false;
 
 		Mutex_Lock(pendingMutex);
 		{
+			if (w->Priority) http_priorityBusy--;
+			w->Priority = false;
+
 			stop = http_terminate;
-			if (!stop && pendingReqs.Count) {
-				request = pendingReqs.Entries[0];
-				hasRequest = true;
-				RequestList_RemoveAt(&pendingReqs, 0);
-			}
+			if (!stop) hasRequest = Http_TakeRequest(w, &request);
+			hasMore = pendingReqs.Count || Http_CanTakePriority();
 		}
 		Mutex_Unlock(pendingMutex);
 
+		/* Only one worker is woken up per signal, so pass it on */
+		if (stop || hasMore) Waitable_Signal(workerWaitable);
 		if (stop) return;
+
 		/* Block until another thread submits a request to do */
 		if (!hasRequest) {
 			Platform_LogConst("Going back to sleep...");
 			Waitable_Wait(workerWaitable);
 			continue;
 		}
-		Http_BeginRequest(&request);
+		Http_BeginRequest(w, &request);
 
 		beg = Stopwatch_Measure();
-		request.Result = Http_SysDo(&request);
+		request.Result = Http_SysDo(w);
 		end = Stopwatch_Measure();
 
 		elapsed = Stopwatch_ElapsedMicroseconds(beg, end) / 1000;
 		Platform_Log3("HTTP: return code %i (http %i), in %i ms",
 					&request.Result, &request.StatusCode, &elapsed);
-		Http_FinishRequest(&request);
+		Http_FinishRequest(w, &request);
 	}
 }
 #endif
@@ -886,17 +1084,21 @@ static void Http_WorkerLoop(void) {
 #define SKIN_SERVER "http://static.classicube.net/skins/"
 #endif
 
+void Http_MakeSkinUrl(String* url, const String* skinName) {
+	if (Utils_IsUrlPrefix(skinName)) {
+		String_Copy(url, skinName);
+	} else {
+		String_AppendConst(url, SKIN_SERVER);
+		String_AppendColorless(url, skinName);
+		String_AppendConst(url, ".png");
+	}
+}
+
 void Http_AsyncGetSkin(const String* skinName) {
 	String url; char urlBuffer[STRING_SIZE];
 	String_InitArray(url, urlBuffer);
 
-	if (Utils_IsUrlPrefix(skinName)) {
-		String_Copy(&url, skinName);
-	} else {
-		String_AppendConst(&url, SKIN_SERVER);
-		String_AppendColorless(&url, skinName);
-		String_AppendConst(&url, ".png");
-	}
+	Http_MakeSkinUrl(&url, skinName);
 	Http_AsyncGetData(&url, false, skinName);
 }
 
@@ -915,20 +1117,35 @@ void Http_AsyncGetDataEx(const String* url, bool priority, const String* id, con
 
 bool Http_GetResult(const String* id, struct HttpRequest* item) {
 	int i;
-	Mutex_Lock(processedMutex);
-	{
-		i = RequestList_Find(&processedReqs, id, item);
-		if (i >= 0) RequestList_RemoveAt(&processedReqs, i);
-	}
-	Mutex_Unlock(processedMutex);
-	return i >= 0;
+	Http_ProcessCompleted();
+
+	i = HttpResults_Find(id, HttpResults_Hash(id));
+	if (i < 0) return false;
+
+	*item = http_results[i].Req;
+	HttpResults_RemoveAt(i);
+	return true;
 }
 
 bool Http_GetCurrent(struct HttpRequest* request, int* progress) {
+	struct HttpWorker* w = NULL;
+	int i;
+
 	Mutex_Lock(curRequestMutex);
 	{
-		*request  = http_curRequest;
-		*progress = http_curProgress;
+		/* Prefer reporting a high priority request (e.g. texture pack download) */
+		for (i = 0; i < http_workersCount; i++) {
+			if (!http_workers[i].Current.ID[0]) continue;
+			if (!w || (http_workers[i].Priority && !w->Priority)) w = &http_workers[i];
+		}
+
+		if (w) {
+			*request  = w->Current;
+			*progress = w->Progress;
+		} else {
+			request->ID[0] = '\0';
+			*progress = ASYNC_PROGRESS_NOTHING;
+		}
 	}
 	Mutex_Unlock(curRequestMutex);
 	return request->ID[0];
@@ -938,6 +1155,7 @@ void Http_ClearPending(void) {
 	Mutex_Lock(pendingMutex);
 	{
 		RequestList_Free(&pendingReqs);
+		RequestList_Free(&priorityReqs);
 	}
 	Mutex_Unlock(pendingMutex);
 	Waitable_Signal(workerWaitable);
@@ -977,29 +1195,55 @@ void Http_UrlEncodeUtf8(String* dst, const String* src) {
 *-----------------------------------------------------Http component------------------------------------------------------*
 *#########################################################################################################################*/
 static void Http_Init(void) {
+	int i;
 	ScheduledTask_Add(30, Http_CleanCacheTask);
 	RequestList_Init(&pendingReqs);
-	RequestList_Init(&processedReqs);
+	RequestList_Init(&priorityReqs);
+	RequestList_Init(&completedReqs);
+	HttpResults_Init();
 	Http_SysInit();
 
 	workerWaitable  = Waitable_Create();
 	pendingMutex    = Mutex_Create();
 	processedMutex  = Mutex_Create();
 	curRequestMutex = Mutex_Create();
+
+#ifdef CC_BUILD_WEB
+	http_workersCount = 1;
+#else
+	http_workersCount = Options_GetInt(OPT_HTTP_WORKERS, 1, HTTP_MAX_WORKERS, 
+									min(HTTP_DEF_WORKERS, HTTP_MAX_WORKERS));
+#endif
+	for (i = 0; i < http_workersCount; i++) {
+		http_workers[i].Index    = i;
+		http_workers[i].Progress = ASYNC_PROGRESS_NOTHING;
+		Http_SysInitWorker(&http_workers[i]);
+	}
+
 #ifndef CC_BUILD_WEB
-	workerThread    = Thread_Start(Http_WorkerLoop, false);
+	for (i = 0; i < http_workersCount; i++) {
+		http_workers[i].Thread = Thread_Start(Http_WorkerLoop, false);
+	}
 #endif
 }
 
 static void Http_Free(void) {
+	int i;
 	http_terminate = true;
 	Http_ClearPending();
 #ifndef CC_BUILD_WEB
-	Thread_Join(workerThread);
+	for (i = 0; i < http_workersCount; i++) {
+		Thread_Join(http_workers[i].Thread);
+	}
 #endif
+	http_workersStarted = 0;
+	http_priorityBusy   = 0;
 
 	RequestList_Free(&pendingReqs);
-	RequestList_Free(&processedReqs);
+	RequestList_Free(&priorityReqs);
+	Http_ProcessCompleted();
+	HttpResults_Free();
+	RequestList_Free(&completedReqs);
 	Http_SysFree();
 
 	Waitable_Free(workerWaitable);
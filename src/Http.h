@@ -45,6 +45,8 @@ void HttpRequest_Free(struct HttpRequest* request);
 /* If url is a skin, downloads from there. (if not, http://static.classicube.net/skins/[skinName].png) */
 /* ID of the request is set to skinName. */
 void Http_AsyncGetSkin(const String* skinName);
+/* Appends the URL a skin is downloaded from to url. (see Http_AsyncGetSkin) */
+void Http_MakeSkinUrl(String* url, const String* skinName);
 /* Asynchronously performs a http GET request. (e.g. to download data) */
 void Http_AsyncGetData(const String* url, bool priority, const String* id);
 /* Asynchronously performs a http HEAD request. (e.g. to get Content-Length header) */
@@ -64,6 +66,7 @@ void Http_UrlEncodeUtf8(String* dst, const String* src);
 bool Http_DescribeError(ReturnCode res, String* dst);
 
 /* Attempts to retrieve a fully completed request. */
+/* NOTE: Must only be called from the main thread. */
 /* NOTE: You MUST check Success for whether it completed successfully. */
 /* (Data may still be non NULL even on error, e.g. on a http 404 error) */
 bool Http_GetResult(const String* id, struct HttpRequest* item);
@@ -4,6 +4,7 @@
 #include "MapRenderer.h"
 #include "Platform.h"
 #include "World.h"
+#include "Utils.h"
 #include "Logger.h"
 #include "Event.h"
 #include "GameStructs.h"
@@ -353,12 +354,12 @@ void Lighting_LightHint(int startX, int startZ) {
 *---------------------------------------------------Lighting component----------------------------------------------------*
 *#########################################################################################################################*/
 static void Lighting_Reset(void) {
-	Mem_Free(Lighting_Heightmap);
+	/* Heightmap is freed along with the rest of World_MapArena */
 	Lighting_Heightmap = NULL;
 }
 
 static void Lighting_OnNewMapLoaded(void) {
-	Lighting_Heightmap = (int16_t*)Mem_Alloc(World.Width * World.Length, 2, "lighting heightmap");
+	Lighting_Heightmap = (int16_t*)Arena_Alloc(&World_MapArena, World.Width * World.Length, 2, "lighting heightmap");
 	Lighting_Refresh();
 }
 
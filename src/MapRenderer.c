@@ -307,12 +307,8 @@ static void MapRenderer_FreeParts(void) {
 	MapRenderer_PartsTranslucent = NULL;
 }
 
+/* NOTE: Chunk info is freed along with the rest of World_MapArena */
 static void MapRenderer_FreeChunks(void) {
-	Mem_Free(mapChunks);
-	Mem_Free(sortedChunks);
-	Mem_Free(renderChunks);
-	Mem_Free(distances);
-
 	mapChunks    = NULL;
 	sortedChunks = NULL;
 	renderChunks = NULL;
@@ -321,6 +317,7 @@ static void MapRenderer_FreeChunks(void) {
 
 static void MapRenderer_AllocateParts(void) {
 	uint32_t count  = MapRenderer_ChunksCount * MapRenderer_1DUsedCount;
+	/* Not from World_MapArena, since parts are reallocated whenever MapRenderer_1DUsedCount changes */
 	partsBuffer_Raw = (struct ChunkPartInfo*)Mem_AllocCleared(count * 2, sizeof(struct ChunkPartInfo), "chunk parts");
 
 	MapRenderer_PartsNormal      = partsBuffer_Raw;
@@ -328,10 +325,10 @@ static void MapRenderer_AllocateParts(void) {
 }
 
 static void MapRenderer_AllocateChunks(void) {
-	mapChunks    = (struct ChunkInfo*) Mem_Alloc(MapRenderer_ChunksCount, sizeof(struct ChunkInfo),  "chunk info");
-	sortedChunks = (struct ChunkInfo**)Mem_Alloc(MapRenderer_ChunksCount, sizeof(struct ChunkInfo*), "sorted chunk info");
-	renderChunks = (struct ChunkInfo**)Mem_Alloc(MapRenderer_ChunksCount, sizeof(struct ChunkInfo*), "render chunk info");
-	distances    = (uint32_t*)Mem_Alloc(MapRenderer_ChunksCount, 4, "chunk distances");
+	mapChunks    = (struct ChunkInfo*) Arena_Alloc(&World_MapArena, MapRenderer_ChunksCount, sizeof(struct ChunkInfo),  "chunk info");
+	sortedChunks = (struct ChunkInfo**)Arena_Alloc(&World_MapArena, MapRenderer_ChunksCount, sizeof(struct ChunkInfo*), "sorted chunk info");
+	renderChunks = (struct ChunkInfo**)Arena_Alloc(&World_MapArena, MapRenderer_ChunksCount, sizeof(struct ChunkInfo*), "render chunk info");
+	distances    = (uint32_t*)Arena_Alloc(&World_MapArena, MapRenderer_ChunksCount, 4, "chunk distances");
 }
 
 static void MapRenderer_ResetPartFlags(void) {
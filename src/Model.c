@@ -23,6 +23,102 @@ struct _ModelsData Models;
 #define AABB_Length(bb) ((bb)->Max.Z - (bb)->Min.Z)
 
 
+/*########################################################################################################################*
+*--------------------------------------------------------Model batching---------------------------------------------------*
+*#########################################################################################################################*/
+/* Vertices of batchable models are transformed into world space on the CPU, then appended to a pass */
+/* with the same texture and alpha test state. Each pass is uploaded and drawn once when flushed, */
+/* so entities sorted by model and texture only need one upload and draw per pass. */
+#define MODEL_BATCH_PASSES   2
+#define MODEL_BATCH_VERTICES 8192
+struct ModelBatchPass { GfxResourceID Tex; bool AlphaTest; int Count; };
+
+static VertexP3fT2fC4b batch_vertices[MODEL_BATCH_PASSES][MODEL_BATCH_VERTICES];
+static struct ModelBatchPass batch_passes[MODEL_BATCH_PASSES];
+static int batch_numPasses;
+static GfxResourceID batch_vb;
+/* Whether batching is enabled, and whether the model currently being drawn is batched */
+static bool batch_enabled, batch_active;
+static struct Matrix batch_transform;
+/* Texture and alpha test state models are currently drawing with */
+static GfxResourceID model_tex;
+static bool model_alphaTest = true;
+
+static void ModelBatch_Flush(void) {
+	struct ModelBatchPass* pass;
+	int i;
+	if (!batch_numPasses) return;
+	Gfx_SetVertexFormat(VERTEX_FORMAT_P3FT2FC4B);
+
+	for (i = 0; i < batch_numPasses; i++) {
+		pass = &batch_passes[i];
+		Gfx_BindTexture(pass->Tex);
+		Gfx_SetAlphaTest(pass->AlphaTest);
+		Gfx_UpdateDynamicVb_IndexedTris(batch_vb, batch_vertices[i], pass->Count);
+	}
+	/* models are rendered with alpha testing on by default */
+	Gfx_SetAlphaTest(true);
+	batch_numPasses = 0;
+}
+
+static void ModelBatch_Add(VertexP3fT2fC4b* src, int count) {
+	struct Matrix* m = &batch_transform;
+	struct ModelBatchPass* pass;
+	VertexP3fT2fC4b* dst;
+	float x, y, z;
+	int i;
+
+	for (i = 0; i < batch_numPasses; i++) {
+		pass = &batch_passes[i];
+		if (pass->Tex == model_tex && pass->AlphaTest == model_alphaTest) break;
+	}
+
+	if (i < batch_numPasses && pass->Count + count > MODEL_BATCH_VERTICES) {
+		ModelBatch_Flush(); i = 0;
+	} else if (i == MODEL_BATCH_PASSES) {
+		ModelBatch_Flush(); i = 0;
+	}
+
+	if (i == batch_numPasses) {
+		pass = &batch_passes[i];
+		pass->Tex       = model_tex;
+		pass->AlphaTest = model_alphaTest;
+		pass->Count     = 0;
+		batch_numPasses++;
+	}
+
+	pass = &batch_passes[i];
+	dst  = &batch_vertices[i][pass->Count];
+	pass->Count += count;
+
+	for (i = 0; i < count; i++, src++, dst++) {
+		x = src->X; y = src->Y; z = src->Z;
+		dst->X = x * m->Row0.X + y * m->Row1.X + z * m->Row2.X + m->Row3.X;
+		dst->Y = x * m->Row0.Y + y * m->Row1.Y + z * m->Row2.Y + m->Row3.Y;
+		dst->Z = x * m->Row0.Z + y * m->Row1.Z + z * m->Row2.Z + m->Row3.Z;
+		dst->Col = src->Col; dst->U = src->U; dst->V = src->V;
+	}
+}
+
+void Model_BeginBatch(void) { batch_enabled = true; }
+
+void Model_EndBatch(void) {
+	ModelBatch_Flush();
+	batch_enabled = false;
+	batch_active  = false;
+}
+
+void Model_BindTexture(GfxResourceID tex) {
+	model_tex = tex;
+	if (!batch_active) Gfx_BindTexture(tex);
+}
+
+void Model_SetAlphaTest(bool enabled) {
+	model_alphaTest = enabled;
+	if (!batch_active) Gfx_SetAlphaTest(enabled);
+}
+
+
 /*########################################################################################################################*
 *------------------------------------------------------------Model--------------------------------------------------------*
 *#########################################################################################################################*/
@@ -38,6 +134,7 @@ void Model_Init(struct Model* model) {
 	model->CalcHumanAnims = false;
 	model->UsesHumanSkin  = false;
 	model->Pushes = true;
+	model->Batchable = false;
 
 	model->Gravity        = 0.08f;
 	model->Drag           = Vec3_Create3(0.91f, 0.98f, 0.91f);
@@ -98,9 +195,18 @@ void Model_Render(struct Model* model, struct Entity* entity) {
 	if (model->Bobbing) pos.Y += entity->Anim.BobbingModel;
 
 	Model_SetupState(model, entity);
-	Gfx_SetVertexFormat(VERTEX_FORMAT_P3FT2FC4B);
-
 	model->GetTransform(entity, pos, &entity->Transform);
+
+	if (batch_enabled && model->Batchable) {
+		batch_active    = true;
+		batch_transform = entity->Transform;
+		model->Draw(entity);
+		return;
+	}
+
+	/* model can't be batched, so draw it after any already batched models */
+	if (batch_enabled) { ModelBatch_Flush(); batch_active = false; }
+	Gfx_SetVertexFormat(VERTEX_FORMAT_P3FT2FC4B);
 	Matrix_Mul(&m, &entity->Transform, &Gfx.View);
 
 	Gfx_LoadMatrix(MATRIX_VIEW, &m);
@@ -120,8 +226,10 @@ void Model_SetupState(struct Model* model, struct Entity* entity) {
 	/* only apply when using humanoid skins */
 	_64x64 &= model->UsesHumanSkin || entity->MobTextureId;
 
-	Models.uScale = entity->uScale * 0.015625f;
-	Models.vScale = entity->vScale * (_64x64 ? 0.015625f : 0.03125f);
+	Models.uScale  = entity->uScale * 0.015625f;
+	Models.vScale  = entity->vScale * (_64x64 ? 0.015625f : 0.03125f);
+	Models.uOffset = entity->uOffset;
+	Models.vOffset = entity->vOffset;
 
 	Models.Cols[0] = col;
 	if (!entity->NoShade) {
@@ -143,7 +251,11 @@ void Model_SetupState(struct Model* model, struct Entity* entity) {
 
 void Model_UpdateVB(void) {
 	struct Model* model = Models.Active;
-	Gfx_UpdateDynamicVb_IndexedTris(Models.Vb, Models.Vertices, model->index);
+	if (batch_active) {
+		ModelBatch_Add(Models.Vertices, model->index);
+	} else {
+		Gfx_UpdateDynamicVb_IndexedTris(Models.Vb, Models.Vertices, model->index);
+	}
 	model->index = 0;
 }
 
@@ -151,24 +263,42 @@ void Model_ApplyTexture(struct Entity* entity) {
 	struct Model* model = Models.Active;
 	struct ModelTex* data;
 	GfxResourceID tex;
+	float uScale, vScale;
 	bool _64x64;
 
 	tex = model->UsesHumanSkin ? entity->TextureId : entity->MobTextureId;
 	if (tex) {
 		Models.skinType = entity->SkinType;
+		uScale = entity->uScale; Models.uOffset = entity->uOffset;
+		vScale = entity->vScale; Models.vOffset = entity->vOffset;
 	} else {
 		data = model->defaultTex;
 		tex  = data->TexID;
 		Models.skinType = data->SkinType;
+		/* skin atlas region does not apply to the model's default texture */
+		uScale = 1.0f; Models.uOffset = 0.0f;
+		vScale = 1.0f; Models.vOffset = 0.0f;
 	}
 
-	Gfx_BindTexture(tex);
+	Model_BindTexture(tex);
 	_64x64 = Models.skinType != SKIN_64x32;
 
-	Models.uScale = entity->uScale * 0.015625f;
-	Models.vScale = entity->vScale * (_64x64 ? 0.015625f : 0.03125f);
+	Models.uScale = uScale * 0.015625f;
+	Models.vScale = vScale * (_64x64 ? 0.015625f : 0.03125f);
 }
 
+/* UV scale/offset for skin texture, hoisted out of the per-vertex loops */
+#define Model_DeclareUVs \
+	float uScale = Models.uScale, uMax = 0.01f * Models.uScale, uOffset = Models.uOffset; \
+	float vScale = Models.vScale, vMax = 0.01f * Models.vScale, vOffset = Models.vOffset; \
+	PackedCol* cols = Models.Cols;
+
+/* NOTE: (v.U >> UV_MAX_SHIFT) is 0 or 1, so * uMax gives same result as * 0.01f * uScale */
+#define Model_WriteUVs \
+	dst->Col = cols[i >> 2]; \
+	dst->U   = (v.U & UV_POS_MASK) * uScale - (v.U >> UV_MAX_SHIFT) * uMax + uOffset; \
+	dst->V   = (v.V & UV_POS_MASK) * vScale - (v.V >> UV_MAX_SHIFT) * vMax + vOffset;
+
 void Model_DrawPart(struct ModelPart* part) {
 	struct Model* model     = Models.Active;
 	struct ModelVertex* src = &model->vertices[part->Offset];
@@ -176,15 +306,12 @@ void Model_DrawPart(struct ModelPart* part) {
 
 	struct ModelVertex v;
 	int i, count = part->Count;
+	Model_DeclareUVs
 
-	for (i = 0; i < count; i++) {
+	for (i = 0; i < count; i++, src++, dst++) {
 		v = *src;
 		dst->X = v.X; dst->Y = v.Y; dst->Z = v.Z;
-		dst->Col = Models.Cols[i >> 2];
-
-		dst->U = (v.U & UV_POS_MASK) * Models.uScale - (v.U >> UV_MAX_SHIFT) * 0.01f * Models.uScale;
-		dst->V = (v.V & UV_POS_MASK) * Models.vScale - (v.V >> UV_MAX_SHIFT) * 0.01f * Models.vScale;
-		src++; dst++;
+		Model_WriteUVs
 	}
 	model->index += count;
 }
@@ -193,48 +320,57 @@ void Model_DrawPart(struct ModelPart* part) {
 #define Model_RotateY t = cosY * v.X - sinY * v.Z; v.Z =  sinY * v.X + cosY * v.Z; v.X = t;
 #define Model_RotateZ t = cosZ * v.X + sinZ * v.Y; v.Y = -sinZ * v.X + cosZ * v.Y; v.X = t;
 
+/* Transforms all vertices of a part, using the given local rotation */
+/* A separate loop is used for each rotation order, to avoid checking order per vertex */
+#define Model_RotateVertices(rotate) \
+	for (i = 0; i < count; i++, src++, dst++) { \
+		v = *src; \
+		v.X -= x; v.Y -= y; v.Z -= z; \
+		rotate \
+		/* Rotate globally (inlined RotY) */ \
+		if (head) { \
+			t = cosHead * v.X - sinHead * v.Z; v.Z = sinHead * v.X + cosHead * v.Z; v.X = t; \
+		} \
+		dst->X = v.X + x; dst->Y = v.Y + y; dst->Z = v.Z + z; \
+		Model_WriteUVs \
+	}
+
+/* Calculates cos and sin of -angle */
+static void Model_CosSin(float angle, float* cosA, float* sinA) {
+	/* Most parts aren't rotated on some axes, so avoid the costly sin/cos calls */
+	/* NOTE: sin(-0) is -0 and sin(0) is 0, so need to use -angle for sin */
+	if (angle == 0.0f) { *cosA = 1.0f; *sinA = -angle; return; }
+
+	*cosA = (float)Math_Cos(-angle);
+	*sinA = (float)Math_Sin(-angle);
+}
+
 void Model_DrawRotate(float angleX, float angleY, float angleZ, struct ModelPart* part, bool head) {
 	struct Model* model     = Models.Active;
 	struct ModelVertex* src = &model->vertices[part->Offset];
 	VertexP3fT2fC4b* dst    = &Models.Vertices[model->index];
 
-	float cosX = (float)Math_Cos(-angleX), sinX = (float)Math_Sin(-angleX);
-	float cosY = (float)Math_Cos(-angleY), sinY = (float)Math_Sin(-angleY);
-	float cosZ = (float)Math_Cos(-angleZ), sinZ = (float)Math_Sin(-angleZ);
+	float cosX, sinX, cosY, sinY, cosZ, sinZ;
 	float t, x = part->RotX, y = part->RotY, z = part->RotZ;
+	float cosHead = Models.cosHead, sinHead = Models.sinHead;
 	
 	struct ModelVertex v;
 	int i, count = part->Count;
-
-	for (i = 0; i < count; i++) {
-		v = *src;
-		v.X -= x; v.Y -= y; v.Z -= z;
-
-		/* Rotate locally */
-		if (Models.Rotation == ROTATE_ORDER_ZYX) {
-			Model_RotateZ
-			Model_RotateY
-			Model_RotateX
-		} else if (Models.Rotation == ROTATE_ORDER_XZY) {
-			Model_RotateX
-			Model_RotateZ
-			Model_RotateY
-		} else if (Models.Rotation == ROTATE_ORDER_YZX) {
-			Model_RotateY
-			Model_RotateZ
-			Model_RotateX
-		}
-
-		/* Rotate globally (inlined RotY) */
-		if (head) {
-			t = Models.cosHead * v.X - Models.sinHead * v.Z; v.Z = Models.sinHead * v.X + Models.cosHead * v.Z; v.X = t;
-		}
-		dst->X = v.X + x; dst->Y = v.Y + y; dst->Z = v.Z + z;
-		dst->Col = Models.Cols[i >> 2];
-
-		dst->U = (v.U & UV_POS_MASK) * Models.uScale - (v.U >> UV_MAX_SHIFT) * 0.01f * Models.uScale;
-		dst->V = (v.V & UV_POS_MASK) * Models.vScale - (v.V >> UV_MAX_SHIFT) * 0.01f * Models.vScale;
-		src++; dst++;
+	Model_DeclareUVs
+
+	Model_CosSin(angleX, &cosX, &sinX);
+	Model_CosSin(angleY, &cosY, &sinY);
+	Model_CosSin(angleZ, &cosZ, &sinZ);
+
+	switch (Models.Rotation) {
+	case ROTATE_ORDER_ZYX:
+		Model_RotateVertices(Model_RotateZ Model_RotateY Model_RotateX); break;
+	case ROTATE_ORDER_XZY:
+		Model_RotateVertices(Model_RotateX Model_RotateZ Model_RotateY); break;
+	case ROTATE_ORDER_YZX:
+		Model_RotateVertices(Model_RotateY Model_RotateZ Model_RotateX); break;
+	default:
+		Model_RotateVertices(;); break;
 	}
 	model->index += count;
 }
@@ -373,10 +509,12 @@ static struct ModelTex* textures_tail;
 
 static void Models_ContextLost(void* obj) {
 	Gfx_DeleteVb(&Models.Vb);
+	Gfx_DeleteVb(&batch_vb);
 }
 
 static void Models_ContextRecreated(void* obj) {
 	Models.Vb = Gfx_CreateDynamicVb(VERTEX_FORMAT_P3FT2FC4B, Models.MaxVertices);
+	batch_vb  = Gfx_CreateDynamicVb(VERTEX_FORMAT_P3FT2FC4B, MODEL_BATCH_VERTICES);
 }
 
 static void Model_Make(struct Model* model) {
@@ -446,7 +584,7 @@ static void HumanModel_DrawModelSet(struct Entity* entity, struct ModelSet* mode
 	int type;
 
 	Model_ApplyTexture(entity);
-	Gfx_SetAlphaTest(false);
+	Model_SetAlphaTest(false);
 
 	type = Models.skinType;
 	set  = &model->Limbs[type & 0x3];
@@ -462,7 +600,7 @@ static void HumanModel_DrawModelSet(struct Entity* entity, struct ModelSet* mode
 	Models.Rotation = ROTATE_ORDER_ZYX;
 	Model_UpdateVB();
 
-	Gfx_SetAlphaTest(true);
+	Model_SetAlphaTest(true);
 	if (type != SKIN_64x32) {
 		Model_DrawPart(&model->TorsoLayer);
 		Model_DrawRotate(entity->Anim.LeftLegX,  0, entity->Anim.LeftLegZ,  &set->LeftLegLayer,  false);
@@ -1202,7 +1340,10 @@ static void FurlessModel_Draw(struct Entity* entity) {
 
 static void SheepModel_Draw(struct Entity* entity) {
 	FurlessModel_Draw(entity);
-	Gfx_BindTexture(fur_tex.TexID);
+	Model_BindTexture(fur_tex.TexID);
+	/* fur is always drawn using the default 64x32 fur texture */
+	Models.uScale  = 0.015625f; Models.vScale  = 0.03125f;
+	Models.uOffset = 0.0f;      Models.vOffset = 0.0f;
 	Model_DrawRotate(-entity->HeadX * MATH_DEG2RAD, 0, 0, &fur_head, true);
 
 	Model_DrawPart(&fur_torso);
@@ -1657,6 +1798,7 @@ static struct Model* BlockModel_GetInstance(void) {
 static VertexP3fT2fC4b defaultVertices[MODEL_BOX_VERTICES * 12];
 
 static void Model_RegisterDefaultModels(void) {
+	struct Model* model;
 	Model_RegisterTexture(&human_tex);
 	Model_RegisterTexture(&chicken_tex);
 	Model_RegisterTexture(&creeper_tex);
@@ -1685,6 +1827,11 @@ static void Model_RegisterDefaultModels(void) {
 	Model_Register(HeadModel_GetInstance());
 	Model_Register(SittingModel_GetInstance());
 	Model_Register(CorpseModel_GetInstance());
+
+	/* block model binds terrain atlases and toggles culling itself, so can't be batched */
+	for (model = models_head; model; model = model->next) {
+		model->Batchable = model != &block_model;
+	}
 }
 
 static void Models_Init(void) {
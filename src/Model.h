@@ -71,6 +71,9 @@ struct Model {
 	/* e.g. for HumanoidModel, when legs are at the peak of their swing, whole model is moved slightly down */
 	bool Bobbing;
 	bool UsesSkin, CalcHumanAnims, UsesHumanSkin, Pushes;
+	/* Whether the model only draws using Model_BindTexture/Model_SetAlphaTest/Model_UpdateVB, */
+	/* and so can be batched together with other entities. (false by default) */
+	bool Batchable;
 
 	float Gravity; Vec3 Drag, GroundFriction;
 
@@ -93,6 +96,8 @@ CC_VAR extern struct _ModelsData {
 	/* U/V scale applied to skin texture when rendering models. */
 	/* Default uScale is 1/32, vScale is 1/32 or 1/64 depending on skin. */
 	float uScale, vScale;
+	/* U/V offset applied to skin texture, non-zero when skin is in a shared skin atlas. */
+	float uOffset, vOffset;
 	/* Angle of offset of head from body rotation */
 	float cosHead, sinHead;
 	/* Order of axes rotation when rendering parts. */
@@ -127,7 +132,16 @@ CC_API void Model_Render(struct Model* model, struct Entity* entity);
 /* NOTE: Model_Render already calls this, you don't normally need to call this. */
 CC_API void Model_SetupState(struct Model* model, struct Entity* entity);
 /* Flushes buffered vertices to the GPU. */
+/* NOTE: If the model is being batched, vertices are instead added to the batch. */
 CC_API void Model_UpdateVB(void);
+/* Starts batching vertices of models which have Batchable set. */
+void Model_BeginBatch(void);
+/* Draws all batched vertices, then stops batching. */
+void Model_EndBatch(void);
+/* Binds the given texture for drawing model vertices. (deferred when batching) */
+CC_API void Model_BindTexture(GfxResourceID tex);
+/* Sets alpha test state for drawing model vertices. (deferred when batching) */
+CC_API void Model_SetAlphaTest(bool enabled);
 /* Applies the skin texture of the given entity to the model. */
 /* Uses model's default texture if the entity doesn't have a custom skin. */
 CC_API void Model_ApplyTexture(struct Entity* entity);
@@ -14,7 +14,7 @@ static StringsBuffer Options_Changed;
 int Options_ChangedCount(void) { return Options_Changed.count;  }
 
 void Options_Free(void) {
-	StringsBuffer_Clear(&Options.entries);
+	EntryList_Clear(&Options);
 	StringsBuffer_Clear(&Options_Changed);
 }
 
@@ -148,7 +148,7 @@ void Options_Load(void) {
 			String_UNSAFE_Separate(&entry, '=', &key, &value);
 
 			if (Options_HasChanged(&key)) continue;
-			StringsBuffer_Remove(&Options.entries, i);
+			EntryList_Remove(&Options, &key);
 		}
 
 		/* Load only options which have not changed */
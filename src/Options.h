@@ -64,6 +64,8 @@
 #define OPT_CLASSIC_HACKS "nostalgia-hacks"
 #define OPT_CLASSIC_ARM_MODEL "nostalgia-classicarm"
 #define OPT_MAX_CHUNK_UPDATES "gfx-maxchunkupdates"
+#define OPT_MAX_PARTICLES "gfx-maxparticles"
+#define OPT_HTTP_WORKERS "http-workers"
 
 extern struct EntryList Options;
 /* Returns the number of options changed via Options_SetXYZ since last save. */
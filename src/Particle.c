@@ -10,15 +10,18 @@
 #include "Game.h"
 #include "Event.h"
 #include "GameStructs.h"
+#include "Options.h"
+#include "Platform.h"
 
 
 /*########################################################################################################################*
 *------------------------------------------------------Particle base------------------------------------------------------*
 *#########################################################################################################################*/
 static GfxResourceID Particles_TexId, Particles_VB;
-#define PARTICLES_MAX 600
+#define PARTICLES_DEF_MAX 2048
+static int particles_max;
+static VertexP3fT2fC4b* particles_vertices;
 static RNGState rnd;
-static bool particle_hitTerrain;
 
 void Particle_DoRender(Vec2* size, Vec3* pos, TextureRec* rec, PackedCol col, VertexP3fT2fC4b* vertices) {
 	struct Matrix* view;
@@ -48,10 +51,89 @@ void Particle_DoRender(Vec2* size, Vec3* pos, TextureRec* rec, PackedCol col, Ve
 				   v.V = rec->V2; vertices[3] = v;
 }
 
-static void Particle_Reset(struct Particle* p, Vec3 pos, Vec3 velocity, float lifetime) {
-	p->lastPos = pos; p->nextPos = pos;
-	p->velocity = velocity;
-	p->lifetime = lifetime;
+/* Stores particles as a structure of arrays, so physics can be integrated over all particles at once. */
+/* Removing a particle moves the last particle into its slot, so removal is O(1). */
+struct ParticlePool {
+	float* lastX; float* lastY; float* lastZ;
+	float* nextX; float* nextY; float* nextZ;
+	float* velX;  float* velY;  float* velZ;
+	float* lifetime;
+	uint8_t* size;
+	uint8_t* dead;
+	/* Per particle data specific to the type of particle */
+	uint8_t* extra;
+	int extraSize;
+	int count, evict;
+	float gravity;
+	bool throughLiquids, removeOnHit;
+};
+#define PARTICLE_FLOAT_FIELDS 10
+
+static void ParticlePool_Init(struct ParticlePool* p, int extraSize, const char* place) {
+	float* data = (float*)Mem_Alloc(particles_max, PARTICLE_FLOAT_FIELDS * 4 + 2 + extraSize, place);
+	p->lastX = data; data += particles_max;
+	p->lastY = data; data += particles_max;
+	p->lastZ = data; data += particles_max;
+	p->nextX = data; data += particles_max;
+	p->nextY = data; data += particles_max;
+	p->nextZ = data; data += particles_max;
+	p->velX  = data; data += particles_max;
+	p->velY  = data; data += particles_max;
+	p->velZ  = data; data += particles_max;
+	p->lifetime = data; data += particles_max;
+
+	/* NOTE: extra data is placed first, so it is still aligned to 4 bytes */
+	p->extra = (uint8_t*)data;
+	p->size  = p->extra + particles_max * extraSize;
+	p->dead  = p->size  + particles_max;
+	p->extraSize = extraSize;
+	p->count = 0; p->evict = 0;
+}
+
+static void ParticlePool_Free(struct ParticlePool* p) {
+	Mem_Free(p->lastX);
+	p->lastX = NULL;
+	p->count = 0;
+}
+
+/* Returns the index of a newly added particle. */
+/* NOTE: When the pool is full, an existing particle is replaced instead. */
+static int ParticlePool_Add(struct ParticlePool* p, Vec3 pos, Vec3 velocity, float lifetime, uint8_t size) {
+	int i;
+	if (p->count < particles_max) {
+		i = p->count++;
+	} else {
+		i = p->evict;
+		p->evict = (i + 1) % particles_max;
+	}
+
+	p->lastX[i] = pos.X; p->nextX[i] = pos.X; p->velX[i] = velocity.X;
+	p->lastY[i] = pos.Y; p->nextY[i] = pos.Y; p->velY[i] = velocity.Y;
+	p->lastZ[i] = pos.Z; p->nextZ[i] = pos.Z; p->velZ[i] = velocity.Z;
+	p->lifetime[i] = lifetime;
+	p->size[i]     = size;
+	return i;
+}
+
+static void ParticlePool_RemoveAt(struct ParticlePool* p, int i) {
+	int last = --p->count;
+	if (i == last) return;
+
+	p->lastX[i] = p->lastX[last]; p->nextX[i] = p->nextX[last]; p->velX[i] = p->velX[last];
+	p->lastY[i] = p->lastY[last]; p->nextY[i] = p->nextY[last]; p->velY[i] = p->velY[last];
+	p->lastZ[i] = p->lastZ[last]; p->nextZ[i] = p->nextZ[last]; p->velZ[i] = p->velZ[last];
+	p->lifetime[i] = p->lifetime[last];
+	p->size[i]     = p->size[last];
+	p->dead[i]     = p->dead[last];
+
+	if (!p->extraSize) return;
+	Mem_Copy(p->extra + i * p->extraSize, p->extra + last * p->extraSize, p->extraSize);
+}
+
+static void ParticlePool_GetPos(struct ParticlePool* p, int i, float t, Vec3* pos) {
+	pos->X = p->lastX[i] + (p->nextX[i] - p->lastX[i]) * t;
+	pos->Y = p->lastY[i] + (p->nextY[i] - p->lastY[i]) * t;
+	pos->Z = p->lastZ[i] + (p->nextZ[i] - p->lastZ[i]) * t;
 }
 
 static bool Particle_CanPass(BlockID block, bool throughLiquids) {
@@ -59,12 +141,10 @@ static bool Particle_CanPass(BlockID block, bool throughLiquids) {
 	return draw == DRAW_GAS || draw == DRAW_SPRITE || (throughLiquids && Blocks.IsLiquid[block]);
 }
 
-static bool Particle_CollideHor(Vec3* nextPos, BlockID block) {
-	Vec3 horPos = Vec3_Create3((float)Math_Floor(nextPos->X), 0.0f, (float)Math_Floor(nextPos->Z));
-	Vec3 min, max;
-	Vec3_Add(&min, &Blocks.MinBB[block], &horPos);
-	Vec3_Add(&max, &Blocks.MaxBB[block], &horPos);
-	return nextPos->X >= min.X && nextPos->Z >= min.Z && nextPos->X < max.X && nextPos->Z < max.Z;
+static bool Particle_CollideHor(float x, float z, BlockID block) {
+	float horX = (float)Math_Floor(x), horZ = (float)Math_Floor(z);
+	return x >= Blocks.MinBB[block].X + horX && z >= Blocks.MinBB[block].Z + horZ 
+		&& x <  Blocks.MaxBB[block].X + horX && z <  Blocks.MaxBB[block].Z + horZ;
 }
 
 static BlockID Particle_GetBlock(int x, int y, int z) {
@@ -75,94 +155,102 @@ static BlockID Particle_GetBlock(int x, int y, int z) {
 	return Env.SidesBlock;
 }
 
-static bool Particle_TestY(struct Particle* p, int y, bool topFace, bool throughLiquids) {
+static void ParticlePool_HitTerrain(struct ParticlePool* p, int i, float y) {
+	p->lastY[i] = y; p->nextY[i] = y;
+	p->velX[i]  = 0.0f; p->velY[i] = 0.0f; p->velZ[i] = 0.0f;
+	if (p->removeOnHit) p->dead[i] = true;
+}
+
+static bool ParticlePool_TestY(struct ParticlePool* p, int i, int y, bool topFace) {
 	BlockID block;
-	Vec3 minBB, maxBB;
 	float collideY;
 	bool collideVer;
 
 	if (y < 0) {
-		p->nextPos.Y = ENTITY_ADJUSTMENT; p->lastPos.Y = ENTITY_ADJUSTMENT;
-		p->velocity  = Vec3_Zero();
-		particle_hitTerrain = true;
+		ParticlePool_HitTerrain(p, i, ENTITY_ADJUSTMENT);
 		return false;
 	}
 
-	block = Particle_GetBlock((int)p->nextPos.X, y, (int)p->nextPos.Z);
-	if (Particle_CanPass(block, throughLiquids)) return true;
-	minBB = Blocks.MinBB[block]; maxBB = Blocks.MaxBB[block];
+	block = Particle_GetBlock((int)p->nextX[i], y, (int)p->nextZ[i]);
+	if (Particle_CanPass(block, p->throughLiquids)) return true;
 
-	collideY   = y + (topFace ? maxBB.Y : minBB.Y);
-	collideVer = topFace ? (p->nextPos.Y < collideY) : (p->nextPos.Y > collideY);
+	collideY   = y + (topFace ? Blocks.MaxBB[block].Y : Blocks.MinBB[block].Y);
+	collideVer = topFace ? (p->nextY[i] < collideY) : (p->nextY[i] > collideY);
 
-	if (collideVer && Particle_CollideHor(&p->nextPos, block)) {
-		float adjust = topFace ? ENTITY_ADJUSTMENT : -ENTITY_ADJUSTMENT;
-		p->lastPos.Y = collideY + adjust;
-		p->nextPos.Y = p->lastPos.Y;
-		p->velocity  = Vec3_Zero();
-		particle_hitTerrain = true;
+	if (collideVer && Particle_CollideHor(p->nextX[i], p->nextZ[i], block)) {
+		ParticlePool_HitTerrain(p, i, collideY + (topFace ? ENTITY_ADJUSTMENT : -ENTITY_ADJUSTMENT));
 		return false;
 	}
 	return true;
 }
 
-static bool Particle_PhysicsTick(struct Particle* p, float gravity, bool throughLiquids, double delta) {
+/* Whether the given particle is stuck inside a block it cannot pass through. */
+static bool ParticlePool_InsideBlock(struct ParticlePool* p, int i) {
 	BlockID cur;
 	float minY, maxY;
-	Vec3 velocity;
-	int y, begY, endY;
 
-	p->lastPos = p->nextPos;
-	cur  = Particle_GetBlock((int)p->nextPos.X, (int)p->nextPos.Y, (int)p->nextPos.Z);
-	minY = Math_Floor(p->nextPos.Y) + Blocks.MinBB[cur].Y;
-	maxY = Math_Floor(p->nextPos.Y) + Blocks.MaxBB[cur].Y;
+	cur  = Particle_GetBlock((int)p->nextX[i], (int)p->nextY[i], (int)p->nextZ[i]);
+	if (Particle_CanPass(cur, p->throughLiquids)) return false;
+
+	minY = Math_Floor(p->nextY[i]) + Blocks.MinBB[cur].Y;
+	maxY = Math_Floor(p->nextY[i]) + Blocks.MaxBB[cur].Y;
+	return p->nextY[i] >= minY && p->nextY[i] < maxY && Particle_CollideHor(p->nextX[i], p->nextZ[i], cur);
+}
+
+static void ParticlePool_Tick(struct ParticlePool* p, double delta) {
+	float gravity  = p->gravity * (float)delta;
+	float velDelta = (float)delta * 3.0f;
+	int i, y, begY, endY, count = p->count;
 
-	if (!Particle_CanPass(cur, throughLiquids) && p->nextPos.Y >= minY
-		&& p->nextPos.Y < maxY && Particle_CollideHor(&p->nextPos, cur)) {
-		return true;
+	/* Particles stuck inside a block are removed without moving */
+	for (i = 0; i < count; i++) {
+		p->lastX[i] = p->nextX[i]; p->lastY[i] = p->nextY[i]; p->lastZ[i] = p->nextZ[i];
+		p->dead[i]  = ParticlePool_InsideBlock(p, i);
 	}
 
-	p->velocity.Y -= gravity * (float)delta;
-	begY = Math_Floor(p->nextPos.Y);
-	
-	Vec3_Mul1(&velocity, &p->velocity, (float)delta * 3.0f);
-	Vec3_Add(&p->nextPos, &p->nextPos, &velocity);
-	endY = Math_Floor(p->nextPos.Y);
+	for (i = 0; i < count; i++) {
+		p->velY[i]  -= gravity;
+		p->nextX[i] += p->velX[i] * velDelta;
+		p->nextY[i] += p->velY[i] * velDelta;
+		p->nextZ[i] += p->velZ[i] * velDelta;
+		p->lifetime[i] -= (float)delta;
+	}
 
-	if (p->velocity.Y > 0.0f) {
-		/* don't test block we are already in */
-		for (y = begY + 1; y <= endY && Particle_TestY(p, y, false, throughLiquids); y++) {}
-	} else {
-		for (y = begY; y >= endY && Particle_TestY(p, y, true, throughLiquids); y--) {}
+	for (i = 0; i < count; i++) {
+		if (p->dead[i]) continue;
+		begY = Math_Floor(p->lastY[i]);
+		endY = Math_Floor(p->nextY[i]);
+
+		if (p->velY[i] > 0.0f) {
+			/* don't test block we are already in */
+			for (y = begY + 1; y <= endY && ParticlePool_TestY(p, i, y, false); y++) {}
+		} else {
+			for (y = begY; y >= endY && ParticlePool_TestY(p, i, y, true); y--) {}
+		}
+		if (p->lifetime[i] < 0.0f) p->dead[i] = true;
 	}
 
-	p->lifetime -= (float)delta;
-	return p->lifetime < 0.0f;
+	/* Iterate backwards, so particles moved into a removed slot have already been checked */
+	for (i = count - 1; i >= 0; i--) {
+		if (p->dead[i]) ParticlePool_RemoveAt(p, i);
+	}
 }
 
 
 /*########################################################################################################################*
 *-------------------------------------------------------Rain particle-----------------------------------------------------*
 *#########################################################################################################################*/
-struct RainParticle { struct Particle base; };
-
-static struct RainParticle rain_Particles[PARTICLES_MAX];
-static int rain_count;
+static struct ParticlePool rain;
 static TextureRec rain_rec = { 2.0f/128.0f, 14.0f/128.0f, 5.0f/128.0f, 16.0f/128.0f };
 
-static bool RainParticle_Tick(struct RainParticle* p, double delta) {
-	particle_hitTerrain = false;
-	return Particle_PhysicsTick(&p->base, 3.5f, false, delta) || particle_hitTerrain;
-}
-
-static void RainParticle_Render(struct RainParticle* p, float t, VertexP3fT2fC4b* vertices) {
+static void RainParticle_Render(int i, float t, VertexP3fT2fC4b* vertices) {
 	Vec3 pos;
 	Vec2 size;
 	PackedCol col;
 	int x, y, z;
 
-	Vec3_Lerp(&pos, &p->base.lastPos, &p->base.nextPos, t);
-	size.X = (float)p->base.size * 0.015625f; size.Y = size.X;
+	ParticlePool_GetPos(&rain, i, t, &pos);
+	size.X = (float)rain.size[i] * 0.015625f; size.Y = size.X;
 
 	x = Math_Floor(pos.X); y = Math_Floor(pos.Y); z = Math_Floor(pos.Z);
 	col = World_Contains(x, y, z) ? Lighting_Col(x, y, z) : Env.SunCol;
@@ -170,39 +258,18 @@ static void RainParticle_Render(struct RainParticle* p, float t, VertexP3fT2fC4b
 }
 
 static void Rain_Render(float t) {
-	VertexP3fT2fC4b vertices[PARTICLES_MAX * 4];
 	VertexP3fT2fC4b* ptr;
 	int i;
-	if (!rain_count) return;
+	if (!rain.count) return;
 	
-	ptr = vertices;
-	for (i = 0; i < rain_count; i++) {
-		RainParticle_Render(&rain_Particles[i], t, ptr);
+	ptr = particles_vertices;
+	for (i = 0; i < rain.count; i++) {
+		RainParticle_Render(i, t, ptr);
 		ptr += 4;
 	}
 
 	Gfx_BindTexture(Particles_TexId);
-	Gfx_UpdateDynamicVb_IndexedTris(Particles_VB, vertices, rain_count * 4);
-}
-
-static void Rain_RemoveAt(int index) {
-	struct RainParticle removed = rain_Particles[index];
-	int i;
-
-	for (i = index; i < rain_count - 1; i++) {
-		rain_Particles[i] = rain_Particles[i + 1];
-	}
-	rain_Particles[rain_count - 1] = removed;
-	rain_count--;
-}
-
-static void Rain_Tick(double delta) {
-	int i;
-	for (i = 0; i < rain_count; i++) {
-		if (RainParticle_Tick(&rain_Particles[i], delta)) {
-			Rain_RemoveAt(i); i--;
-		}
-	}
+	Gfx_UpdateDynamicVb_IndexedTris(Particles_VB, particles_vertices, rain.count * 4);
 }
 
 
@@ -210,29 +277,25 @@ static void Rain_Tick(double delta) {
 *------------------------------------------------------Terrain particle---------------------------------------------------*
 *#########################################################################################################################*/
 struct TerrainParticle {
-	struct Particle base;
 	TextureRec rec;
 	TextureLoc texLoc;
 	BlockID block;
 };
 
-static struct TerrainParticle terrain_particles[PARTICLES_MAX];
-static int terrain_count;
-static uint16_t terrain_1DCount[ATLAS1D_MAX_ATLASES];
-static uint16_t terrain_1DIndices[ATLAS1D_MAX_ATLASES];
-
-static bool TerrainParticle_Tick(struct TerrainParticle* p, double delta) {
-	return Particle_PhysicsTick(&p->base, 5.4f, true, delta);
-}
+static struct ParticlePool terrain;
+static int terrain_1DCount[ATLAS1D_MAX_ATLASES];
+static int terrain_1DIndices[ATLAS1D_MAX_ATLASES];
+#define Terrain_Get(i) ((struct TerrainParticle*)(terrain.extra + (i) * sizeof(struct TerrainParticle)))
 
-static void TerrainParticle_Render(struct TerrainParticle* p, float t, VertexP3fT2fC4b* vertices) {
+static void TerrainParticle_Render(int i, float t, VertexP3fT2fC4b* vertices) {
+	struct TerrainParticle* p = Terrain_Get(i);
 	PackedCol col = PACKEDCOL_WHITE;
 	Vec3 pos;
 	Vec2 size;
 	int x, y, z;
 
-	Vec3_Lerp(&pos, &p->base.lastPos, &p->base.nextPos, t);
-	size.X = (float)p->base.size * 0.015625f; size.Y = size.X;
+	ParticlePool_GetPos(&terrain, i, t, &pos);
+	size.X = (float)terrain.size[i] * 0.015625f; size.Y = size.X;
 	
 	if (!Blocks.FullBright[p->block]) {
 		x = Math_Floor(pos.X); y = Math_Floor(pos.Y); z = Math_Floor(pos.Z);
@@ -255,8 +318,8 @@ static void Terrain_Update1DCounts(void) {
 		terrain_1DCount[i]   = 0;
 		terrain_1DIndices[i] = 0;
 	}
-	for (i = 0; i < terrain_count; i++) {
-		index = Atlas1D_Index(terrain_particles[i].texLoc);
+	for (i = 0; i < terrain.count; i++) {
+		index = Atlas1D_Index(Terrain_Get(i)->texLoc);
 		terrain_1DCount[index] += 4;
 	}
 	for (i = 1; i < Atlas1D.Count; i++) {
@@ -265,22 +328,21 @@ static void Terrain_Update1DCounts(void) {
 }
 
 static void Terrain_Render(float t) {
-	VertexP3fT2fC4b vertices[PARTICLES_MAX * 4];
 	VertexP3fT2fC4b* ptr;
 	int offset = 0;
 	int i, index;
-	if (!terrain_count) return;
+	if (!terrain.count) return;
 
 	Terrain_Update1DCounts();
-	for (i = 0; i < terrain_count; i++) {
-		index = Atlas1D_Index(terrain_particles[i].texLoc);
-		ptr   = &vertices[terrain_1DIndices[index]];
+	for (i = 0; i < terrain.count; i++) {
+		index = Atlas1D_Index(Terrain_Get(i)->texLoc);
+		ptr   = &particles_vertices[terrain_1DIndices[index]];
 
-		TerrainParticle_Render(&terrain_particles[i], t, ptr);
+		TerrainParticle_Render(i, t, ptr);
 		terrain_1DIndices[index] += 4;
 	}
 
-	Gfx_SetDynamicVbData(Particles_VB, vertices, terrain_count * 4);
+	Gfx_SetDynamicVbData(Particles_VB, particles_vertices, terrain.count * 4);
 	for (i = 0; i < Atlas1D.Count; i++) {
 		int partCount = terrain_1DCount[i];
 		if (!partCount) continue;
@@ -291,26 +353,6 @@ static void Terrain_Render(float t) {
 	}
 }
 
-static void Terrain_RemoveAt(int index) {
-	struct TerrainParticle removed = terrain_particles[index];
-	int i;
-
-	for (i = index; i < terrain_count - 1; i++) {
-		terrain_particles[i] = terrain_particles[i + 1];
-	}
-	terrain_particles[terrain_count - 1] = removed;
-	terrain_count--;
-}
-
-static void Terrain_Tick(double delta) {
-	int i;
-	for (i = 0; i < terrain_count; i++) {
-		if (TerrainParticle_Tick(&terrain_particles[i], delta)) {
-			Terrain_RemoveAt(i); i--;
-		}
-	}
-}
-
 
 /*########################################################################################################################*
 *--------------------------------------------------------Particles--------------------------------------------------------*
@@ -322,7 +364,7 @@ static void Particles_FileChanged(void* obj, struct Stream* stream, const String
 }
 
 void Particles_Render(double delta, float t) {
-	if (!terrain_count && !rain_count) return;
+	if (!terrain.count && !rain.count) return;
 	if (Gfx.LostContext) return;
 
 	Gfx_SetTexturing(true);
@@ -337,8 +379,8 @@ void Particles_Render(double delta, float t) {
 }
 
 void Particles_Tick(struct ScheduledTask* task) {
-	Terrain_Tick(task->Interval);
-	Rain_Tick(task->Interval);
+	ParticlePool_Tick(&terrain, task->Interval);
+	ParticlePool_Tick(&rain,    task->Interval);
 }
 
 void Particles_BreakBlockEffect(IVec3 coords, BlockID old, BlockID now) {
@@ -361,7 +403,7 @@ void Particles_BreakBlockEffect(IVec3 coords, BlockID old, BlockID now) {
 	/* per-particle variables */
 	Vec3 velocity;
 	float life;
-	int x, y, z, type;
+	int x, y, z, i, type;
 
 	if (now != BLOCK_AIR || Blocks.Draw[old] == DRAW_GAS) return;
 	IVec3_ToVec3(&origin, &coords);
@@ -409,25 +451,22 @@ void Particles_BreakBlockEffect(IVec3 coords, BlockID old, BlockID now) {
 				rec.U2 = min(rec.U2, maxU2) - 0.01f * uScale;
 				rec.V2 = min(rec.V2, maxV2) - 0.01f * vScale;
 
-				if (terrain_count == PARTICLES_MAX) Terrain_RemoveAt(0);
-				p = &terrain_particles[terrain_count++];
-
 				life = 0.3f + Random_Float(&rnd) * 1.2f;
 				Vec3_Add(&pos, &origin, &cell);
-				Particle_Reset(&p->base, pos, velocity, life);
+				type = Random_Range(&rnd, 0, 30);
+				i = ParticlePool_Add(&terrain, pos, velocity, life, 
+									(uint8_t)(type >= 28 ? 12 : (type >= 25 ? 10 : 8)));
 
+				p = Terrain_Get(i);
 				p->rec    = rec;
 				p->texLoc = loc;
 				p->block  = old;
-				type = Random_Range(&rnd, 0, 30);
-				p->base.size = (uint8_t)(type >= 28 ? 12 : (type >= 25 ? 10 : 8));
 			}
 		}
 	}
 }
 
 void Particles_RainSnowEffect(Vec3 pos) {
-	struct RainParticle* p;
 	Vec3 origin = pos;
 	Vec3 offset, velocity;
 	int i, type;
@@ -441,14 +480,9 @@ void Particles_RainSnowEffect(Vec3 pos) {
 		offset.Y = Random_Float(&rnd) * 0.1f + 0.01f;
 		offset.Z = Random_Float(&rnd);
 
-		if (rain_count == PARTICLES_MAX) Rain_RemoveAt(0);
-		p = &rain_Particles[rain_count++];
-
 		Vec3_Add(&pos, &origin, &offset);
-		Particle_Reset(&p->base, pos, velocity, 40.0f);
-
 		type = Random_Range(&rnd, 0, 30);
-		p->base.size = (uint8_t)(type >= 28 ? 2 : (type >= 25 ? 4 : 3));
+		ParticlePool_Add(&rain, pos, velocity, 40.0f, (uint8_t)(type >= 28 ? 2 : (type >= 25 ? 4 : 3)));
 	}
 }
 
@@ -460,7 +494,7 @@ static void Particles_ContextLost(void* obj) {
 	Gfx_DeleteVb(&Particles_VB); 
 }
 static void Particles_ContextRecreated(void* obj) {
-	Particles_VB = Gfx_CreateDynamicVb(VERTEX_FORMAT_P3FT2FC4B, PARTICLES_MAX * 4);
+	Particles_VB = Gfx_CreateDynamicVb(VERTEX_FORMAT_P3FT2FC4B, particles_max * 4);
 }
 static void Particles_BreakBlockEffect_Handler(void* obj, IVec3 coords, BlockID old, BlockID now) {
 	Particles_BreakBlockEffect(coords, old, now);
@@ -469,6 +503,14 @@ static void Particles_BreakBlockEffect_Handler(void* obj, IVec3 coords, BlockID
 static void Particles_Init(void) {
 	ScheduledTask_Add(GAME_DEF_TICKS, Particles_Tick);
 	Random_SeedFromCurrentTime(&rnd);
+
+	particles_max = Options_GetInt(OPT_MAX_PARTICLES, 100, GFX_MAX_VERTICES / 4, PARTICLES_DEF_MAX);
+	particles_vertices = (VertexP3fT2fC4b*)Mem_Alloc(particles_max * 4, sizeof(VertexP3fT2fC4b), "particle vertices");
+
+	ParticlePool_Init(&terrain, sizeof(struct TerrainParticle), "terrain particles");
+	terrain.gravity = 5.4f; terrain.throughLiquids = true;
+	ParticlePool_Init(&rain, 0, "rain particles");
+	rain.gravity    = 3.5f; rain.removeOnHit       = true;
 	Particles_ContextRecreated(NULL);	
 
 	Event_RegisterBlock(&UserEvents.BlockChanged,   NULL, Particles_BreakBlockEffect_Handler);
@@ -480,6 +522,9 @@ static void Particles_Init(void) {
 static void Particles_Free(void) {
 	Gfx_DeleteTexture(&Particles_TexId);
 	Particles_ContextLost(NULL);
+	ParticlePool_Free(&terrain);
+	ParticlePool_Free(&rain);
+	Mem_Free(particles_vertices);
 
 	Event_UnregisterBlock(&UserEvents.BlockChanged,   NULL, Particles_BreakBlockEffect_Handler);
 	Event_UnregisterEntry(&TextureEvents.FileChanged, NULL, Particles_FileChanged);
@@ -487,7 +532,7 @@ static void Particles_Free(void) {
 	Event_UnregisterVoid(&GfxEvents.ContextRecreated, NULL, Particles_ContextRecreated);
 }
 
-static void Particles_Reset(void) { rain_count = 0; terrain_count = 0; }
+static void Particles_Reset(void) { rain.count = 0; terrain.count = 0; }
 
 struct IGameComponent Particles_Component = {
 	Particles_Init,  /* Init  */
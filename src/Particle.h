@@ -10,13 +10,6 @@ struct IGameComponent;
 struct ScheduledTask;
 extern struct IGameComponent Particles_Component;
 
-struct Particle {
-	Vec3 velocity;
-	float lifetime;
-	Vec3 lastPos, nextPos;
-	uint8_t size;
-};
-
 /* http://www.opengl-tutorial.org/intermediate-tutorials/billboards-particles/billboards/ */
 void Particle_DoRender(Vec2* size, Vec3* pos, TextureRec* rec, PackedCol col, VertexP3fT2fC4b* vertices);
 void Particles_Render(double delta, float t);
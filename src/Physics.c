@@ -2,11 +2,14 @@
 #include "ExtMath.h"
 #include "Block.h"
 #include "World.h"
+#include "Utils.h"
 #include "Platform.h"
 #include "ExtMath.h"
 #include "Funcs.h"
 #include "Logger.h"
 #include "Entity.h"
+#include "Event.h"
+#include "GameStructs.h"
 
 
 /*########################################################################################################################*
@@ -131,6 +134,65 @@ static struct SearcherState searcherDefaultStates[SEARCHER_STATES_MIN];
 static uint32_t searcherCapacity = SEARCHER_STATES_MIN;
 struct SearcherState* Searcher_States = searcherDefaultStates;
 
+/* Whether each 16x16x16 chunk of the map contains any solid blocks. */
+/* Computed lazily, so that large empty areas (e.g. the sky) can be skipped over cheaply. */
+enum SEARCHER_CHUNK { CHUNK_UNKNOWN, CHUNK_NO_SOLID, CHUNK_HAS_SOLID };
+static uint8_t* searcherChunks;
+static int searcherChunksX, searcherChunksY, searcherChunksZ;
+
+static void Searcher_ResetChunks(void) {
+	/* Flags are freed along with the rest of World_MapArena */
+	searcherChunks = NULL;
+}
+
+static void Searcher_CalcChunk(int cx, int cy, int cz, uint8_t* flags) {
+	int minX = cx << 4, maxX = min(minX + 15, World.MaxX);
+	int minY = cy << 4, maxY = min(minY + 15, World.MaxY);
+	int minZ = cz << 4, maxZ = min(minZ + 15, World.MaxZ);
+	int x, y, z;
+
+	for (y = minY; y <= maxY; y++) {
+		for (z = minZ; z <= maxZ; z++) {
+			for (x = minX; x <= maxX; x++) {
+				if (Blocks.Collide[World_GetBlock(x, y, z)] != COLLIDE_SOLID) continue;
+				*flags = CHUNK_HAS_SOLID; return;
+			}
+		}
+	}
+	*flags = CHUNK_NO_SOLID;
+}
+
+/* Returns whether the chunk containing the given coordinates has no solid blocks at all. */
+/* NOTE: Coordinates must lie inside the map. */
+static bool Searcher_ChunkEmpty(int x, int y, int z) {
+	int cx = x >> 4, cy = y >> 4, cz = z >> 4;
+	uint8_t* flags;
+
+	if (!searcherChunks) {
+		searcherChunksX = (World.Width  + 15) >> 4;
+		searcherChunksY = (World.Height + 15) >> 4;
+		searcherChunksZ = (World.Length + 15) >> 4;
+		searcherChunks  = (uint8_t*)Arena_AllocCleared(&World_MapArena, searcherChunksX * searcherChunksY * searcherChunksZ, 1, "collision chunk flags");
+	}
+
+	flags = &searcherChunks[(cy * searcherChunksZ + cz) * searcherChunksX + cx];
+	if (*flags == CHUNK_UNKNOWN) Searcher_CalcChunk(cx, cy, cz, flags);
+	return *flags == CHUNK_NO_SOLID;
+}
+
+void Searcher_OnBlockChanged(int x, int y, int z, BlockID block) {
+	uint8_t* flags;
+	if (!searcherChunks) return;
+	flags = &searcherChunks[((y >> 4) * searcherChunksZ + (z >> 4)) * searcherChunksX + (x >> 4)];
+
+	if (Blocks.Collide[block] == COLLIDE_SOLID) {
+		*flags = CHUNK_HAS_SOLID;
+	} else if (*flags == CHUNK_HAS_SOLID) {
+		/* Might have removed the last solid block in the chunk */
+		*flags = CHUNK_UNKNOWN;
+	}
+}
+
 static void Searcher_QuickSort(int left, int right) {
 	struct SearcherState* keys = Searcher_States; struct SearcherState key;
 
@@ -186,6 +248,10 @@ int Searcher_FindReachableBlocks(struct Entity* entity, struct AABB* entityBB, s
 	for (y = min.Y; y <= max.Y; y++) {
 		for (z = min.Z; z <= max.Z; z++) {
 			for (x = min.X; x <= max.X; x++) {
+				/* Skip rest of the row inside this chunk when it has no solid blocks */
+				if (World_Contains(x, y, z) && Searcher_ChunkEmpty(x, y, z)) {
+					x |= 0x0F; continue;
+				}
 				block = World_GetPhysicsBlock(x, y, z);
 				if (Blocks.Collide[block] != COLLIDE_SOLID) continue;
 
@@ -232,3 +298,26 @@ void Searcher_Free(void) {
 	Searcher_States  = searcherDefaultStates;
 	searcherCapacity = SEARCHER_STATES_MIN;
 }
+
+static void Searcher_OnBlockDefChanged(void* obj) {
+	/* Map is still the same size, so just recalculate all the flags */
+	if (!searcherChunks) return;
+	Mem_Set(searcherChunks, CHUNK_UNKNOWN, searcherChunksX * searcherChunksY * searcherChunksZ);
+}
+
+static void Searcher_Init(void) {
+	Event_RegisterVoid(&BlockEvents.BlockDefChanged, NULL, Searcher_OnBlockDefChanged);
+}
+
+static void Searcher_FreeAll(void) {
+	Event_UnregisterVoid(&BlockEvents.BlockDefChanged, NULL, Searcher_OnBlockDefChanged);
+	Searcher_ResetChunks();
+	Searcher_Free();
+}
+
+struct IGameComponent Searcher_Component = {
+	Searcher_Init,        /* Init  */
+	Searcher_FreeAll,     /* Free  */
+	Searcher_ResetChunks, /* Reset */
+	Searcher_ResetChunks  /* OnNewMap */
+};
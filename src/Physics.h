@@ -8,6 +8,8 @@
    Copyright 2014-2019 ClassiCube | Licensed under BSD-3
 */
 struct Entity;
+struct IGameComponent;
+extern struct IGameComponent Searcher_Component;
 
 /* Descibes an axis aligned bounding box. */
 struct AABB { Vec3 Min, Max; };
@@ -36,4 +38,7 @@ extern struct SearcherState* Searcher_States;
 int Searcher_FindReachableBlocks(struct Entity* entity, struct AABB* entityBB, struct AABB* entityExtentBB);
 void Searcher_CalcTime(Vec3* vel, struct AABB *entityBB, struct AABB* blockBB, float* tx, float* ty, float* tz);
 void Searcher_Free(void);
+/* Updates cached collision state of the chunk containing the given coordinates. */
+/* NOTE: Must be called whenever a block in the map is changed. */
+void Searcher_OnBlockChanged(int x, int y, int z, BlockID block);
 #endif
@@ -57,6 +57,7 @@ const ReturnCode ReturnCode_SocketWouldBlock = WSAEWOULDBLOCK;
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/mman.h>
 #include <utime.h>
 #include <signal.h>
 
@@ -126,60 +127,221 @@ CC_NOINLINE static void Platform_AllocFailed(const char* place) {
 }
 
 #if defined CC_BUILD_WIN
+static void* Mem_RawAlloc(uint32_t numBytes, bool cleared) {
+	return HeapAlloc(heap, cleared ? HEAP_ZERO_MEMORY : 0, numBytes);
+}
+static void* Mem_RawRealloc(void* mem, uint32_t numBytes) { return HeapReAlloc(heap, 0, mem, numBytes); }
+static void  Mem_RawFree(void* mem) { HeapFree(heap, 0, mem); }
+
+void* Mem_Reserve(uint32_t numBytes) { return VirtualAlloc(NULL, numBytes, MEM_RESERVE, PAGE_NOACCESS); }
+bool  Mem_Commit(void* addr, uint32_t numBytes) {
+	return VirtualAlloc(addr, numBytes, MEM_COMMIT, PAGE_READWRITE) != NULL;
+}
+void Mem_Decommit(void* addr, uint32_t numBytes) { VirtualFree(addr, numBytes, MEM_DECOMMIT); }
+void Mem_Release(void* addr, uint32_t numBytes)  { VirtualFree(addr, 0, MEM_RELEASE); }
+#elif defined CC_BUILD_POSIX
+static void* Mem_RawAlloc(uint32_t numBytes, bool cleared) {
+	return cleared ? calloc(1, numBytes) : malloc(numBytes);
+}
+static void* Mem_RawRealloc(void* mem, uint32_t numBytes) { return realloc(mem, numBytes); }
+static void  Mem_RawFree(void* mem) { free(mem); }
+
+#if defined CC_BUILD_WEB
+/* mmap is emulated by allocating all of the memory upfront */
+void* Mem_Reserve(uint32_t numBytes) { return NULL; }
+bool  Mem_Commit(void* addr, uint32_t numBytes) { return false; }
+void Mem_Decommit(void* addr, uint32_t numBytes) { }
+void Mem_Release(void* addr, uint32_t numBytes)  { }
+#else
+void* Mem_Reserve(uint32_t numBytes) {
+	void* addr = mmap(NULL, numBytes, PROT_NONE, MAP_PRIVATE | MAP_ANON, -1, 0);
+	return addr == MAP_FAILED ? NULL : addr;
+}
+bool Mem_Commit(void* addr, uint32_t numBytes) {
+	return mprotect(addr, numBytes, PROT_READ | PROT_WRITE) == 0;
+}
+void Mem_Decommit(void* addr, uint32_t numBytes) {
+	/* Replacing the pages with new anonymous ones guarantees they are 0 when next committed */
+	/* (MADV_DONTNEED only guarantees that on Linux, elsewhere it is just a hint) */
+	mmap(addr, numBytes, PROT_NONE, MAP_FIXED | MAP_PRIVATE | MAP_ANON, -1, 0);
+}
+void Mem_Release(void* addr, uint32_t numBytes) { munmap(addr, numBytes); }
+#endif
+#endif
+
+#ifndef CC_BUILD_MEMTRACK
+static void MemTrack_Init(void) { }
+
 void* Mem_TryAlloc(uint32_t numElems, uint32_t elemsSize) {
-	uint32_t numBytes = numElems * elemsSize; /* TODO: avoid overflow here */
-	return HeapAlloc(heap, 0, numBytes);
+	return Mem_RawAlloc(numElems * elemsSize, false); /* TODO: avoid overflow here */
 }
 
 void* Mem_Alloc(uint32_t numElems, uint32_t elemsSize, const char* place) {
-	uint32_t numBytes = numElems * elemsSize; /* TODO: avoid overflow here */
-	void* ptr = HeapAlloc(heap, 0, numBytes);
+	void* ptr = Mem_RawAlloc(numElems * elemsSize, false); /* TODO: avoid overflow here */
 	if (!ptr) Platform_AllocFailed(place);
 	return ptr;
 }
 
 void* Mem_AllocCleared(uint32_t numElems, uint32_t elemsSize, const char* place) {
-	uint32_t numBytes = numElems * elemsSize; /* TODO: avoid overflow here */
-	void* ptr = HeapAlloc(heap, HEAP_ZERO_MEMORY, numBytes);
+	void* ptr = Mem_RawAlloc(numElems * elemsSize, true); /* TODO: avoid overflow here */
 	if (!ptr) Platform_AllocFailed(place);
 	return ptr;
 }
 
 void* Mem_Realloc(void* mem, uint32_t numElems, uint32_t elemsSize, const char* place) {
-	uint32_t numBytes = numElems * elemsSize; /* TODO: avoid overflow here */
-	void* ptr = HeapReAlloc(heap, 0, mem, numBytes);
+	void* ptr = Mem_RawRealloc(mem, numElems * elemsSize); /* TODO: avoid overflow here */
 	if (!ptr) Platform_AllocFailed(place);
 	return ptr;
 }
 
 void Mem_Free(void* mem) {
-	if (mem) HeapFree(heap, 0, mem);
+	if (mem) Mem_RawFree(mem);
 }
-#elif defined CC_BUILD_POSIX
+#else
+/* Every allocation is prefixed by a header recording its size and which tag it counts towards. */
+/* Header is 16 bytes so the returned memory keeps the alignment of the underlying allocator. */
+struct MemHeader { uint32_t Size, Tag, _padding[2]; };
+#define MEM_HEADER_SIZE sizeof(struct MemHeader)
+#define MEM_LOOKUP_SIZE (MEM_MAX_TAGS * 4)
+
+static struct MemTag mem_tags[MEM_MAX_TAGS];
+static int mem_tagsCount;
+static uint64_t mem_live, mem_peak;
+/* Place strings are usually literals, so tags are looked up by pointer first */
+static struct MemLookup { const char* Place; int Tag; } mem_lookup[MEM_LOOKUP_SIZE];
+static int mem_lookupCount;
+static void* mem_lock;
+
+/* Called from Platform_Init, before any other threads are started */
+static void MemTrack_Init(void) {
+	/* Mutex_Create allocates too, so that allocation happens without a lock */
+	mem_lock = Mutex_Create();
+}
+static void MemTrack_Lock(void)   { if (mem_lock) Mutex_Lock(mem_lock); }
+static void MemTrack_Unlock(void) { if (mem_lock) Mutex_Unlock(mem_lock); }
+
+static bool MemTrack_PlaceEquals(const char* a, const char* b) {
+	for (; *a && *a == *b; a++, b++) {}
+	return *a == *b;
+}
+
+static int MemTrack_GetTag(const char* place) {
+	struct MemLookup* entry;
+	int i, tag;
+	i = (int)(((uintptr_t)place >> 2) % MEM_LOOKUP_SIZE);
+
+	for (;;) {
+		entry = &mem_lookup[i];
+		if (entry->Place == place) return entry->Tag;
+		if (!entry->Place) break;
+		i = (i + 1) % MEM_LOOKUP_SIZE;
+	}
+
+	/* Same string may exist at different addresses (e.g. in a plugin) */
+	for (tag = 0; tag < mem_tagsCount; tag++) {
+		if (MemTrack_PlaceEquals(mem_tags[tag].Place, place)) break;
+	}
+
+	if (tag == mem_tagsCount) {
+		/* Last tag is shared by everything once there are too many tags */
+		if (tag == MEM_MAX_TAGS) return MEM_MAX_TAGS - 1;
+		mem_tags[tag].Place = tag == MEM_MAX_TAGS - 1 ? "(other)" : place;
+		mem_tagsCount++;
+	}
+
+	/* Always leave a free slot, so that lookups terminate */
+	if (mem_lookupCount < MEM_LOOKUP_SIZE - 1) {
+		entry->Place = place; entry->Tag = tag;
+		mem_lookupCount++;
+	}
+	return tag;
+}
+
+static void* MemTrack_Add(struct MemHeader* header, uint32_t size, const char* place) {
+	struct MemTag* tag;
+	if (!header) return NULL;
+	MemTrack_Lock();
+
+	header->Size = size;
+	header->Tag  = MemTrack_GetTag(place);
+	tag = &mem_tags[header->Tag];
+
+	tag->Allocs++;
+	tag->Live += size;
+	tag->Peak  = max(tag->Peak, tag->Live);
+	mem_live  += size;
+	mem_peak   = max(mem_peak, mem_live);
+
+	MemTrack_Unlock();
+	return (uint8_t*)header + MEM_HEADER_SIZE;
+}
+
+static struct MemHeader* MemTrack_Remove(void* mem) {
+	struct MemHeader* header = (struct MemHeader*)((uint8_t*)mem - MEM_HEADER_SIZE);
+	struct MemTag* tag;
+	MemTrack_Lock();
+
+	tag = &mem_tags[header->Tag];
+	tag->Frees++;
+	tag->Live -= header->Size;
+	mem_live  -= header->Size;
+
+	MemTrack_Unlock();
+	return header;
+}
+
 void* Mem_TryAlloc(uint32_t numElems, uint32_t elemsSize) {
-	return malloc(numElems * elemsSize); /* TODO: avoid overflow here */
+	uint32_t numBytes = numElems * elemsSize; /* TODO: avoid overflow here */
+	return MemTrack_Add(Mem_RawAlloc(numBytes + MEM_HEADER_SIZE, false), numBytes, "(untagged)");
 }
 
 void* Mem_Alloc(uint32_t numElems, uint32_t elemsSize, const char* place) {
-	void* ptr = malloc(numElems * elemsSize); /* TODO: avoid overflow here */
+	uint32_t numBytes = numElems * elemsSize; /* TODO: avoid overflow here */
+	void* ptr = MemTrack_Add(Mem_RawAlloc(numBytes + MEM_HEADER_SIZE, false), numBytes, place);
 	if (!ptr) Platform_AllocFailed(place);
 	return ptr;
 }
 
 void* Mem_AllocCleared(uint32_t numElems, uint32_t elemsSize, const char* place) {
-	void* ptr = calloc(numElems, elemsSize); /* TODO: avoid overflow here */
+	uint32_t numBytes = numElems * elemsSize; /* TODO: avoid overflow here */
+	void* ptr = MemTrack_Add(Mem_RawAlloc(numBytes + MEM_HEADER_SIZE, true), numBytes, place);
 	if (!ptr) Platform_AllocFailed(place);
 	return ptr;
 }
 
 void* Mem_Realloc(void* mem, uint32_t numElems, uint32_t elemsSize, const char* place) {
-	void* ptr = realloc(mem, numElems * elemsSize); /* TODO: avoid overflow here */
+	uint32_t numBytes = numElems * elemsSize; /* TODO: avoid overflow here */
+	void* ptr;
+	if (!mem) return Mem_Alloc(numElems, elemsSize, place);
+
+	ptr = Mem_RawRealloc(MemTrack_Remove(mem), numBytes + MEM_HEADER_SIZE);
+	ptr = MemTrack_Add((struct MemHeader*)ptr, numBytes, place);
 	if (!ptr) Platform_AllocFailed(place);
 	return ptr;
 }
 
 void Mem_Free(void* mem) {
-	if (mem) free(mem);
+	if (mem) Mem_RawFree(MemTrack_Remove(mem));
+}
+
+int Mem_GetTags(struct MemTag* tags, uint64_t* live, uint64_t* peak) {
+	int count;
+	MemTrack_Lock();
+
+	count = mem_tagsCount;
+	Mem_Copy(tags, mem_tags, count * sizeof(struct MemTag));
+	*live = mem_live;
+	*peak = mem_peak;
+
+	MemTrack_Unlock();
+	return count;
+}
+
+void Mem_MarkTags(void) {
+	int i;
+	MemTrack_Lock();
+	for (i = 0; i < mem_tagsCount; i++) { mem_tags[i].Mark = mem_tags[i].Live; }
+	MemTrack_Unlock();
 }
 #endif
 
@@ -474,6 +636,12 @@ ReturnCode File_SetModifiedTime(const String* path, TimeMS time) {
 /* Don't need special execute permission on windows */
 ReturnCode File_MarkExecutable(const String* path) { return 0; }
 
+ReturnCode File_Delete(const String* path) {
+	TCHAR str[300];
+	Platform_ConvertString(str, path);
+	return DeleteFile(str) ? 0 : GetLastError();
+}
+
 static ReturnCode File_Do(FileHandle* file, const String* path, DWORD access, DWORD createMode) {
 	TCHAR str[300]; 
 	Platform_ConvertString(str, path);
@@ -624,6 +792,12 @@ ReturnCode File_MarkExecutable(const String* path) {
 	return chmod(str, st.st_mode) == -1 ? errno : 0;
 }
 
+ReturnCode File_Delete(const String* path) {
+	char str[600];
+	Platform_ConvertString(str, path);
+	return unlink(str) == -1 ? errno : 0;
+}
+
 static ReturnCode File_Do(FileHandle* file, const String* path, int mode) {
 	char str[600]; 
 	Platform_ConvertString(str, path);
@@ -820,9 +994,12 @@ void Mutex_Unlock(void* handle) {
 	if (res) Logger_Abort2(res, "Unlocking mutex");
 }
 
+/* Behaves like an auto reset event on Windows. A signal while no thread is waiting */
+/* is not lost, and instead makes the next wait return immediately. */
 struct WaitData {
 	pthread_cond_t  cond;
 	pthread_mutex_t mutex;
+	bool signalled;
 };
 
 void* Waitable_Create(void) {
@@ -833,6 +1010,8 @@ void* Waitable_Create(void) {
 	if (res) Logger_Abort2(res, "Creating waitable");
 	res = pthread_mutex_init(&ptr->mutex, NULL);
 	if (res) Logger_Abort2(res, "Creating waitable mutex");
+
+	ptr->signalled = false;
 	return ptr;
 }
 
@@ -849,7 +1028,12 @@ void Waitable_Free(void* handle) {
 
 void Waitable_Signal(void* handle) {
 	struct WaitData* ptr = (struct WaitData*)handle;
-	int res = pthread_cond_signal(&ptr->cond);
+	int res;
+
+	Mutex_Lock(&ptr->mutex);
+	ptr->signalled = true;
+	res = pthread_cond_signal(&ptr->cond);
+	Mutex_Unlock(&ptr->mutex);
 	if (res) Logger_Abort2(res, "Signalling event");
 }
 
@@ -858,8 +1042,11 @@ void Waitable_Wait(void* handle) {
 	int res;
 
 	Mutex_Lock(&ptr->mutex);
-	res = pthread_cond_wait(&ptr->cond, &ptr->mutex);
-	if (res) Logger_Abort2(res, "Waitable wait");
+	while (!ptr->signalled) {
+		res = pthread_cond_wait(&ptr->cond, &ptr->mutex);
+		if (res) Logger_Abort2(res, "Waitable wait");
+	}
+	ptr->signalled = false;
 	Mutex_Unlock(&ptr->mutex);
 }
 
@@ -877,8 +1064,12 @@ void Waitable_WaitFor(void* handle, uint32_t milliseconds) {
 	ts.tv_nsec %= NS_PER_SEC;
 
 	Mutex_Lock(&ptr->mutex);
-	res = pthread_cond_timedwait(&ptr->cond, &ptr->mutex, &ts);
-	if (res && res != ETIMEDOUT) Logger_Abort2(res, "Waitable wait for");
+	while (!ptr->signalled) {
+		res = pthread_cond_timedwait(&ptr->cond, &ptr->mutex, &ts);
+		if (res == ETIMEDOUT) break;
+		if (res) Logger_Abort2(res, "Waitable wait for");
+	}
+	ptr->signalled = false;
 	Mutex_Unlock(&ptr->mutex);
 }
 #endif
@@ -1875,6 +2066,7 @@ void Platform_Init(void) {
 
 	Platform_InitStopwatch();
 	heap = GetProcessHeap();
+	MemTrack_Init();
 	
 	res = WSAStartup(MAKEWORD(2, 2), &wsaData);
 	if (res) Logger_Warn(res, "starting WSA");
@@ -2000,6 +2192,7 @@ int Platform_ConvertUniString(void* data, const UniString* src) {
 }
 
 static void Platform_InitCommon(void) {
+	MemTrack_Init();
 	signal(SIGCHLD, SIG_IGN);
 	/* So writing to closed socket doesn't raise SIGPIPE */
 	signal(SIGPIPE, SIG_IGN);
@@ -97,12 +97,37 @@ CC_API void* Mem_AllocCleared(uint32_t numElems, uint32_t elemsSize, const char*
 CC_API void* Mem_Realloc(void* mem, uint32_t numElems, uint32_t elemsSize, const char* place);
 /* Frees an allocated a block of memory. Does nothing when passed NULL. */
 CC_API void  Mem_Free(void* mem);
+/* Reserves a range of address space, without any memory backing it yet. */
+/* Returns NULL if reserving failed, or is unsupported on this platform. */
+void* Mem_Reserve(uint32_t numBytes);
+/* Backs part of reserved address space with memory, so it can be used. Returns false on failure. */
+/* NOTE: Address and size should be multiples of the page size. */
+bool  Mem_Commit(void* addr, uint32_t numBytes);
+/* Returns the memory backing part of reserved address space to the OS, leaving it reserved. */
+/* NOTE: When committed again afterwards, the memory's contents will be all 0. */
+void  Mem_Decommit(void* addr, uint32_t numBytes);
+/* Releases address space previously returned by Mem_Reserve. */
+void  Mem_Release(void* addr, uint32_t numBytes);
 /* Sets the contents of a block of memory to the given value. */
 void Mem_Set(void* dst, uint8_t value, uint32_t numBytes);
 /* Copies a block of memory to another block of memory. */
 /* NOTE: These blocks MUST NOT overlap. */
 void Mem_Copy(void* dst, const void* src, uint32_t numBytes);
 
+#ifdef CC_BUILD_MEMTRACK
+/* Max number of distinct tags (place strings) allocations are counted towards. */
+#define MEM_MAX_TAGS 256
+/* Statistics for all allocations made with the same place string. */
+/* NOTE: Mem_TryAlloc allocations are counted towards "(untagged)". */
+/* NOTE: Mem_Realloc counts as a free from the old tag, then an allocation to the new tag. */
+struct MemTag { const char* Place; uint32_t Allocs, Frees; uint64_t Live, Peak, Mark; };
+/* Copies statistics of every tag, as well as total live and peak allocated bytes. */
+/* Returns number of tags copied. (tags must be able to hold MEM_MAX_TAGS) */
+CC_API int  Mem_GetTags(struct MemTag* tags, uint64_t* live, uint64_t* peak);
+/* Sets Mark of every tag to its current live bytes, for later comparison. */
+CC_API void Mem_MarkTags(void);
+#endif
+
 /* Logs a debug message to console. */
 void Platform_Log(const String* message);
 void Platform_LogConst(const char* message);
@@ -144,6 +169,8 @@ CC_API ReturnCode File_GetModifiedTime(const String* path, TimeMS* ms);
 CC_API ReturnCode File_SetModifiedTime(const String* path, TimeMS ms);
 /* Marks a file as being executable. */
 CC_API ReturnCode File_MarkExecutable(const String* path);
+/* Deletes the given file. */
+CC_API ReturnCode File_Delete(const String* path);
 
 /* Attempts to create a new (or overwrite) file for writing. */
 /* NOTE: If the file already exists, its contents are discarded. */
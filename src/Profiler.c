@@ -0,0 +1,165 @@
+#include "Profiler.h"
+#include "Platform.h"
+#include "Stream.h"
+#include "Logger.h"
+#include "Funcs.h"
+#include "GameStructs.h"
+
+bool Profiler_Enabled, Profiler_ShowOverlay;
+static const char* const profile_names[PROFILE_COUNT] = {
+	"Frame", "Tasks", "Network", "Physics", "Render 3D",
+	"Entities", "Particles", "Environment", "Map update",
+	"Map normal", "Map translucent", "GUI", "End frame"
+};
+
+static uint64_t scope_beg[PROFILE_COUNT];
+static uint32_t frame_us[PROFILE_COUNT];
+static uint8_t  scope_depth[PROFILE_COUNT];
+static int cur_depth;
+
+/* Totals over the current window, and averages of the last completed window */
+static uint64_t window_us[PROFILE_COUNT];
+static uint32_t window_max[PROFILE_COUNT];
+static int window_frames;
+static float report_avg[PROFILE_COUNT], report_max[PROFILE_COUNT];
+
+void Profiler_BeginScope(int scope) {
+	scope_depth[scope] = cur_depth++;
+	scope_beg[scope]   = Stopwatch_Measure();
+}
+
+void Profiler_EndScope(int scope) {
+	uint64_t end = Stopwatch_Measure();
+	frame_us[scope] += (uint32_t)Stopwatch_ElapsedMicroseconds(scope_beg[scope], end);
+	cur_depth--;
+}
+
+
+/*########################################################################################################################*
+*----------------------------------------------------------CSV dump-------------------------------------------------------*
+*#########################################################################################################################*/
+static struct Stream csv_stream;
+static bool csv_open;
+static uint8_t csv_buffer[8192];
+static uint32_t csv_len;
+
+static void Profiler_FlushCSV(void) {
+	ReturnCode res;
+	if (!csv_len) return;
+
+	res = Stream_Write(&csv_stream, csv_buffer, csv_len);
+	csv_len = 0;
+	if (res) { Logger_Warn(res, "writing profile CSV"); Profiler_StopCSV(); }
+}
+
+static void Profiler_AddCSV(const String* row) {
+	if (csv_len + row->length > sizeof(csv_buffer)) Profiler_FlushCSV();
+	if (!csv_open) return;
+
+	Mem_Copy(csv_buffer + csv_len, row->buffer, row->length);
+	csv_len += row->length;
+}
+
+static void Profiler_WriteRow(void) {
+	String row; char rowBuffer[256];
+	int i, time;
+	String_InitArray(row, rowBuffer);
+
+	for (i = 0; i < PROFILE_COUNT; i++) {
+		time = frame_us[i];
+		String_Format1(&row, i ? ",%i" : "%i", &time);
+	}
+	String_AppendConst(&row, "\r\n");
+	Profiler_AddCSV(&row);
+}
+
+ReturnCode Profiler_StartCSV(const String* path) {
+	String row; char rowBuffer[256];
+	ReturnCode res;
+	int i;
+
+	if (csv_open) Profiler_StopCSV();
+	res = Stream_CreateFile(&csv_stream, path);
+	if (res) return res;
+
+	csv_open = true;
+	csv_len  = 0;
+	String_InitArray(row, rowBuffer);
+
+	for (i = 0; i < PROFILE_COUNT; i++) {
+		String_Format1(&row, i ? ",%c" : "%c", profile_names[i]);
+	}
+	String_AppendConst(&row, "\r\n");
+	Profiler_AddCSV(&row);
+	return 0;
+}
+
+void Profiler_StopCSV(void) {
+	ReturnCode res;
+	if (!csv_open) return;
+
+	/* FlushCSV may fail and call StopCSV again */
+	Profiler_FlushCSV();
+	if (!csv_open) return;
+	csv_open = false;
+
+	res = csv_stream.Close(&csv_stream);
+	if (res) Logger_Warn(res, "closing profile CSV");
+}
+
+bool Profiler_WritingCSV(void) { return csv_open; }
+
+
+/*########################################################################################################################*
+*-----------------------------------------------------------Report--------------------------------------------------------*
+*#########################################################################################################################*/
+static void Profiler_UpdateReport(void) {
+	int i;
+	for (i = 0; i < PROFILE_COUNT; i++) {
+		report_avg[i] = (float)window_us[i] / window_frames / 1000.0f;
+		report_max[i] = window_max[i] / 1000.0f;
+
+		window_us[i]  = 0;
+		window_max[i] = 0;
+	}
+	window_frames = 0;
+}
+
+void Profiler_EndFrame(void) {
+	int i;
+	if (Profiler_Enabled) {
+		if (csv_open) Profiler_WriteRow();
+
+		for (i = 0; i < PROFILE_COUNT; i++) {
+			window_us[i] += frame_us[i];
+			window_max[i] = max(window_max[i], frame_us[i]);
+		}
+		window_frames++;
+
+		/* Averages are recalculated roughly once a second */
+		if (window_us[PROFILE_FRAME] >= 1000 * 1000) Profiler_UpdateReport();
+		Mem_Set(frame_us, 0, sizeof(frame_us));
+	}
+
+	cur_depth = 0;
+	Profiler_Enabled = Profiler_ShowOverlay || csv_open;
+}
+
+void Profiler_Describe(int scope, String* str) {
+	int i;
+	for (i = 0; i < scope_depth[scope]; i++) { String_AppendConst(str, "  "); }
+
+	String_Format3(str, "%c: %f2 ms avg, %f2 ms max", profile_names[scope], 
+					&report_avg[scope], &report_max[scope]);
+}
+
+static void Profiler_Free(void) {
+	Profiler_StopCSV();
+	Profiler_ShowOverlay = false;
+	Profiler_Enabled     = false;
+}
+
+struct IGameComponent Profiler_Component = {
+	NULL,         /* Init  */
+	Profiler_Free /* Free  */
+};
@@ -0,0 +1,41 @@
+#ifndef CC_PROFILER_H
+#define CC_PROFILER_H
+#include "String.h"
+/* Measures how long is spent in each subsystem per frame, for diagnosing frame drops.
+   Copyright 2014-2019 ClassiCube | Licensed under BSD-3
+*/
+struct IGameComponent;
+extern struct IGameComponent Profiler_Component;
+
+/* Scopes that are timed. Scopes may be nested, and may be entered multiple times in a frame. */
+enum ProfilerScope {
+	PROFILE_FRAME, PROFILE_TASKS, PROFILE_NETWORK, PROFILE_PHYSICS, PROFILE_RENDER3D,
+	PROFILE_ENTITIES, PROFILE_PARTICLES, PROFILE_ENVIRONMENT, PROFILE_MAP_UPDATE,
+	PROFILE_MAP_NORMAL, PROFILE_MAP_TRANSLUCENT, PROFILE_GUI, PROFILE_END_FRAME, PROFILE_COUNT
+};
+
+/* Whether scopes are currently being timed. */
+/* NOTE: Only changes in Profiler_EndFrame, so scopes are never left unbalanced. */
+CC_VAR extern bool Profiler_Enabled;
+/* Whether the timings overlay is shown on screen. */
+extern bool Profiler_ShowOverlay;
+
+CC_API void Profiler_BeginScope(int scope);
+CC_API void Profiler_EndScope(int scope);
+/* Starts timing the given scope. Costs only a branch when profiling is disabled. */
+#define Profiler_Begin(scope) do { if (Profiler_Enabled) Profiler_BeginScope(scope); } while (0)
+/* Stops timing the given scope, adding elapsed time to this frame's total for the scope. */
+#define Profiler_End(scope)   do { if (Profiler_Enabled) Profiler_EndScope(scope); } while (0)
+/* Records timings of the current frame, then resets them for the next frame. */
+void Profiler_EndFrame(void);
+
+/* Appends the name and average/maximum time spent in the given scope over the last second. */
+/* NOTE: Name is indented by how deeply nested the scope was. */
+void Profiler_Describe(int scope, String* str);
+/* Starts writing timings of every frame (in microseconds) to the given CSV file. */
+ReturnCode Profiler_StartCSV(const String* path);
+/* Stops writing timings to the CSV file, flushing any buffered rows. */
+void Profiler_StopCSV(void);
+/* Whether timings are currently being written to a CSV file. */
+bool Profiler_WritingCSV(void);
+#endif
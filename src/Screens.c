@@ -19,6 +19,8 @@
 #include "Block.h"
 #include "Menus.h"
 #include "World.h"
+#include "Entity.h"
+#include "Profiler.h"
 
 struct InventoryScreen {
 	Screen_Layout
@@ -273,6 +275,7 @@ static void StatusScreen_MakeText(struct StatusScreen* s, String* status) {
 
 		indices = ICOUNT(Game_Vertices);
 		String_Format1(status, "%i vertices", &indices);
+		if (Entities.NamesDrawn) String_Format1(status, ", %i names", &Entities.NamesDrawn);
 
 		ping = Ping_AveragePingMS();
 		if (ping) String_Format1(status, ", ping %i ms", &ping);
@@ -312,6 +315,24 @@ static void StatusScreen_DrawPosition(struct StatusScreen* s) {
 	Gfx_UpdateDynamicVb_IndexedTris(Models.Vb, vertices, count);
 }
 
+static void StatusScreen_DrawProfile(struct StatusScreen* s) {
+	String str; char strBuffer[STRING_SIZE];
+	struct DrawTextArgs args;
+	int i, y, lineHeight;
+
+	y = s->line2.y + s->line2.height + 2;
+	lineHeight = Drawer2D_FontHeight(&s->font, true);
+
+	for (i = 0; i < PROFILE_COUNT; i++, y += lineHeight) {
+		String_InitArray(str, strBuffer);
+		Profiler_Describe(i, &str);
+
+		DrawTextArgs_Make(&args, &str, &s->font, true);
+		Drawer2D_DrawGlyphText(&args, 2, y);
+	}
+	Drawer2D_FlushGlyphs();
+}
+
 static bool StatusScreen_HacksChanged(struct StatusScreen* s) {
 	struct HacksComp* hacks = &LocalPlayer_Instance.Hacks;
 	return hacks->Speeding != s->speed || hacks->HalfSpeeding != s->halfSpeed || hacks->Flying != s->fly
@@ -429,6 +450,8 @@ static void StatusScreen_Render(void* screen, double delta) {
 		StatusScreen_DrawPosition(s);
 		Elem_Render(&s->line2, delta);
 	}
+
+	if (Profiler_ShowOverlay) StatusScreen_DrawProfile(s);
 	Gfx_SetTexturing(false);
 }
 
@@ -740,11 +763,7 @@ static void ChatScreen_OpenInput(struct ChatScreen* s, const String* initialText
 
 static String ChatScreen_GetChat(void* obj, int i) {
 	i += *((int*)obj); /* argument is offset into chat */
-
-	if (i >= 0 && i < Chat_Log.count) {
-		return StringsBuffer_UNSAFE_Get(&Chat_Log, i);
-	}
-	return String_Empty;
+	return Chat_GetLog(i);
 }
 
 static String ChatScreen_GetStatus(void* obj, int i)       { return Chat_Status[i]; }
@@ -788,7 +807,7 @@ static void ChatScreen_ConstructWidgets(struct ChatScreen* s) {
 }
 
 static void ChatScreen_SetInitialMessages(struct ChatScreen* s) {
-	s->chatIndex = Chat_Log.count - Gui_Chatlines;
+	s->chatIndex = Chat_LogCount - Gui_Chatlines;
 	TextGroupWidget_RedrawAll(&s->chat);
 	TextWidget_Set(&s->announcement, &Chat_Announcement, &s->announcementFont);
 
@@ -813,7 +832,7 @@ static void ChatScreen_CheckOtherStatuses(struct ChatScreen* s) {
 
 	/* Is terrain/texture pack currently being downloaded? */
 	if (!hasRequest || !String_Equals(&identifier, &texPack)) {
-		if (s->status.textures[0].ID) {
+		if (s->status.textures[0].Width) {
 			Chat_Status[0].length = 0;
 			TextGroupWidget_Redraw(&s->status, 0);
 		}
@@ -880,8 +899,9 @@ static void ChatElem_Recreate(struct TextGroupWidget* group, char code) {
 }
 
 static int ChatScreen_ClampIndex(int index) {
-	int maxIndex = Chat_Log.count - Gui_Chatlines;
-	int minIndex = min(0, maxIndex);
+	int maxIndex = Chat_LogCount - Gui_Chatlines;
+	/* older messages are no longer kept in memory */
+	int minIndex = min(max(0, Chat_LogCount - CHAT_LOG_MAX), maxIndex);
 	Math_Clamp(index, minIndex, maxIndex);
 	return index;
 }
@@ -916,7 +936,7 @@ static void ChatScreen_EnterInput(struct ChatScreen* s, bool close) {
 	SpecialInputWidget_SetActive(&s->altText, false);
 
 	/* Reset chat when user has scrolled up in chat history */
-	defaultIndex = Chat_Log.count - Gui_Chatlines;
+	defaultIndex = Chat_LogCount - Gui_Chatlines;
 	if (s->chatIndex != defaultIndex) {
 		s->chatIndex = defaultIndex;
 		TextGroupWidget_RedrawAll(&s->chat);
@@ -1133,11 +1153,12 @@ static void ChatScreen_Render(void* screen, double delta) {
 	y = s->clientStatus.y + s->clientStatus.height;
 	for (i = 0; i < s->clientStatus.lines; i++) {
 		tex = s->clientStatus.textures[i];
-		if (!tex.ID) continue;
+		if (!tex.Width) continue;
 
-		y -= tex.Height; tex.Y = y;
-		Texture_Render(&tex);
+		y -= tex.Height;
+		TextGroupWidget_RenderLine(&s->clientStatus, i, y);
 	}
+	Drawer2D_FlushGlyphs();
 
 	now = DateTime_CurrentUTC_MS();
 	if (s->handlesAllInput) {
@@ -1147,11 +1168,14 @@ static void ChatScreen_Render(void* screen, double delta) {
 		for (i = 0; i < s->chat.lines; i++) {
 			tex    = s->chat.textures[i];
 			logIdx = s->chatIndex + i;
-			if (!tex.ID) continue;
+			if (!tex.Width) continue;
 
-			if (logIdx < 0 || logIdx >= Chat_Log.count) continue;
-			if (Chat_GetLogTime(logIdx) + (10 * 1000) >= now) Texture_Render(&tex);
+			if (logIdx < 0 || logIdx >= Chat_LogCount) continue;
+			if (Chat_GetLogTime(logIdx) + (10 * 1000) >= now) {
+				TextGroupWidget_RenderLine(&s->chat, i, tex.Y);
+			}
 		}
+		Drawer2D_FlushGlyphs();
 	}
 
 	Elem_Render(&s->announcement, delta);
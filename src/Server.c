@@ -22,6 +22,7 @@
 #include "Inventory.h"
 #include "Platform.h"
 #include "GameStructs.h"
+#include "Profiler.h"
 
 static char nameBuffer[STRING_SIZE];
 static char motdBuffer[STRING_SIZE];
@@ -202,7 +203,9 @@ static void SPConnection_SendData(const uint8_t* data, uint32_t len) { }
 static void SPConnection_Tick(struct ScheduledTask* task) {
 	if (Server.Disconnected) return;
 	if ((ticks % 3) == 0) { /* 60 -> 20 ticks a second */
+		Profiler_Begin(PROFILE_PHYSICS);
 		Physics_Tick();
+		Profiler_End(PROFILE_PHYSICS);
 		Server_CheckAsyncResources();
 	}
 	ticks++;
@@ -518,6 +521,12 @@ static void MPConnection_Reset(void) {
 	Server_Free();
 }
 
+static void Server_TickTask(struct ScheduledTask* task) {
+	Profiler_Begin(PROFILE_NETWORK);
+	Server.Tick(task);
+	Profiler_End(PROFILE_NETWORK);
+}
+
 static void Server_Init(void) {
 	String_InitArray(Server.Name,    nameBuffer);
 	String_InitArray(Server.MOTD,    motdBuffer);
@@ -529,7 +538,7 @@ static void Server_Init(void) {
 		MPConnection_Init();
 	}
 
-	ScheduledTask_Add(GAME_NET_TICKS, Server.Tick);
+	ScheduledTask_Add(GAME_NET_TICKS, Server_TickTask);
 	String_AppendConst(&Server.AppName, GAME_APP_NAME);
 }
 
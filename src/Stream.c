@@ -332,11 +332,17 @@ static ReturnCode Stream_BufferedSeek(struct Stream* s, uint32_t position) {
 	return res;
 }
 
+static ReturnCode Stream_BufferedLength(struct Stream* s, uint32_t* length) {
+	struct Stream* source = s->Meta.Buffered.Source;
+	return source->Length(source, length);
+}
+
 void Stream_ReadonlyBuffered(struct Stream* s, struct Stream* source, void* data, uint32_t size) {
 	Stream_Init(s);
 	s->Read   = Stream_BufferedRead;
 	s->ReadU8 = Stream_BufferedReadU8;
 	s->Seek   = Stream_BufferedSeek;
+	s->Length = Stream_BufferedLength;
 
 	s->Meta.Buffered.Left   = 0;
 	s->Meta.Buffered.End    = 0;	
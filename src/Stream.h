@@ -32,6 +32,7 @@ struct Stream {
 		FileHandle File;
 		void* Inflate;
 		struct { uint8_t* Cur; uint32_t Left, Length; uint8_t* Base; } Mem;
+		struct { uint8_t* Cur; uint32_t Left, Length; uint8_t* Base; void* Bmp; } Decoded;
 		struct { struct Stream* Source; uint32_t Left, Length; } Portion;
 		struct { uint8_t* Cur; uint32_t Left, Length; uint8_t* Base; struct Stream* Source; uint32_t End; } Buffered;
 		struct { uint8_t* Cur; uint32_t Left, Last;   uint8_t* Base; struct Stream* Source; } Ogg;
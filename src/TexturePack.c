@@ -36,9 +36,10 @@ static float L_flameHeat[LIQUID_ANIM_MAX * LIQUID_ANIM_MAX];
 static RNGState L_rnd;
 static bool L_rndInitalised;
 
-static void LavaAnimation_Tick(BitmapCol* ptr, int size) {
+static void LavaAnimation_Tick(BitmapCol* scan0, int size, int stride) {
 	int mask = size - 1, shift = Math_Log2(size);
 	float soupHeat, potHeat, col;
+	BitmapCol* ptr;
 	int x, y, i = 0;
 
 	if (!L_rndInitalised) {
@@ -47,6 +48,7 @@ static void LavaAnimation_Tick(BitmapCol* ptr, int size) {
 	}
 	
 	for (y = 0; y < size; y++) {
+		ptr = scan0 + y * stride;
 		for (x = 0; x < size; x++) {
 			/* Calculate the colour at this coordinate in the heatmap */
 
@@ -106,9 +108,10 @@ static float W_flameHeat[LIQUID_ANIM_MAX * LIQUID_ANIM_MAX];
 static RNGState W_rnd;
 static bool W_rndInitalised;
 
-static void WaterAnimation_Tick(BitmapCol* ptr, int size) {
+static void WaterAnimation_Tick(BitmapCol* scan0, int size, int stride) {
 	int mask = size - 1, shift = Math_Log2(size);
 	float soupHeat, col;
+	BitmapCol* ptr;
 	int x, y, i = 0;
 
 	if (!W_rndInitalised) {
@@ -117,6 +120,7 @@ static void WaterAnimation_Tick(BitmapCol* ptr, int size) {
 	}
 	
 	for (y = 0; y < size; y++) {
+		ptr = scan0 + y * stride;
 		for (x = 0; x < size; x++) {
 			/* Calculate the colour at this coordinate in the heatmap */
 			soupHeat =
@@ -224,28 +228,127 @@ static void Animations_ReadDescription(struct Stream* stream, const String* path
 	}
 }
 
-#define ANIMS_FAST_SIZE 64
-static void Animations_Draw(struct AnimationData* data, TextureLoc texLoc, int size) {
-	int dstX = Atlas1D_Index(texLoc), srcX;
-	int dstY = Atlas1D_RowId(texLoc) * Atlas2D.TileSize;
-	GfxResourceID tex;
+/* Animated tiles are drawn into a staging copy of the rows of each 1D atlas they span, */
+/* so each 1D atlas is only uploaded (and has its mipmaps generated) once per tick. */
+struct AnimationAtlas {
+	Bitmap Bmp;             /* Copy of rows MinRow to MaxRow of this 1D atlas */
+	int MinRow, MaxRow;     /* Range of rows that have animated tiles */
+	int DirtyMin, DirtyMax; /* Range of rows that changed this tick */
+};
+static struct AnimationAtlas anims_atlases[ATLAS1D_MAX_ATLASES];
+/* Whether each tile changed this tick, so unchanged tiles between changed ones aren't uploaded */
+static bool anims_dirty[ATLAS2D_TILES_PER_ROW * ATLAS2D_MAX_ROWS_COUNT];
+static bool anims_staged;
 
-	uint8_t buffer[Bitmap_DataSize(ANIMS_FAST_SIZE, ANIMS_FAST_SIZE)];
-	uint8_t* ptr = buffer;
-	Bitmap frame;
+static void Animations_IncludeTile(TextureLoc texLoc) {
+	struct AnimationAtlas* atlas = &anims_atlases[Atlas1D_Index(texLoc)];
+	int row = Atlas1D_RowId(texLoc);
+
+	atlas->MinRow = min(atlas->MinRow, row);
+	atlas->MaxRow = max(atlas->MaxRow, row);
+}
+
+static void Animations_FreeStaging(void) {
+	int i;
+	for (i = 0; i < ATLAS1D_MAX_ATLASES; i++) {
+		Mem_Free(anims_atlases[i].Bmp.Scan0);
+		anims_atlases[i].Bmp.Scan0 = NULL;
+	}
+	anims_staged = false;
+}
+
+static void Animations_InitStaging(void) {
+	struct AnimationAtlas* atlas;
+	int tileSize = Atlas2D.TileSize;
+	int i, row, tile;
+
+	Animations_FreeStaging();
+	anims_staged = true;
+	if (!Atlas2D.Bmp.Scan0) return;
+
+	for (i = 0; i < Atlas1D.Count; i++) {
+		anims_atlases[i].MinRow   = Atlas1D.TilesPerAtlas;
+		anims_atlases[i].MaxRow   = -1;
+		anims_atlases[i].DirtyMin = Atlas1D.TilesPerAtlas;
+		anims_atlases[i].DirtyMax = -1;
+	}
+	Mem_Set(anims_dirty, 0, sizeof(anims_dirty));
+
+#ifndef CC_BUILD_WEB
+	if (useLavaAnim)  Animations_IncludeTile(LAVA_TEX_LOC);
+	if (useWaterAnim) Animations_IncludeTile(WATER_TEX_LOC);
+#endif
+	for (i = 0; i < anims_count; i++) {
+		Animations_IncludeTile(anims_list[i].TexLoc);
+	}
+
+	for (i = 0; i < Atlas1D.Count; i++) {
+		atlas = &anims_atlases[i];
+		if (atlas->MaxRow < atlas->MinRow) continue;
+		Bitmap_Allocate(&atlas->Bmp, tileSize, (atlas->MaxRow - atlas->MinRow + 1) * tileSize);
+
+		/* Tiles between animated tiles in the range are uploaded too, so need their current pixels */
+		for (row = atlas->MinRow; row <= atlas->MaxRow; row++) {
+			tile = (i << Atlas1D.Shift) | row;
+			Bitmap_UNSAFE_CopyBlock(Atlas2D_TileX(tile) * tileSize, Atlas2D_TileY(tile) * tileSize,
+				0, (row - atlas->MinRow) * tileSize, &Atlas2D.Bmp, &atlas->Bmp, tileSize);
+		}
+	}
+}
+
+/* Uploads each run of consecutive changed rows of a 1D atlas */
+static void Animations_UploadAtlas(int i) {
+	struct AnimationAtlas* atlas = &anims_atlases[i];
+	int tileSize = Atlas2D.TileSize;
+	GfxResourceID tex = Atlas1D.TexIds[i];
+	int base = i << Atlas1D.Shift;
+	int row, end;
+	Bitmap part;
+
+	for (row = atlas->DirtyMin; row <= atlas->DirtyMax; row = end) {
+		if (!anims_dirty[base | row]) { end = row + 1; continue; }
+
+		for (end = row; end <= atlas->DirtyMax && anims_dirty[base | end]; end++) {
+			anims_dirty[base | end] = false;
+		}
 
-	/* cannot allocate memory on the stack for very big animation.png frames */
-	if (size > ANIMS_FAST_SIZE) {	
-		ptr = (uint8_t*)Mem_Alloc(size * size, 4, "anim frame");
+		Bitmap_Init(part, tileSize, (end - row) * tileSize,
+			(uint8_t*)Bitmap_RawRow(&atlas->Bmp, (row - atlas->MinRow) * tileSize));
+		if (tex) { Gfx_UpdateTexturePart(tex, 0, row * tileSize, &part, Gfx.Mipmaps); }
 	}
-	Bitmap_Init(frame, size, size, ptr);
+}
+
+/* Uploads the changed rows of every 1D atlas */
+static void Animations_Upload(void) {
+	struct AnimationAtlas* atlas;
+	int i;
+
+	for (i = 0; i < Atlas1D.Count; i++) {
+		atlas = &anims_atlases[i];
+		if (atlas->DirtyMax < atlas->DirtyMin) continue;
+		Animations_UploadAtlas(i);
+
+		atlas->DirtyMin = Atlas1D.TilesPerAtlas;
+		atlas->DirtyMax = -1;
+	}
+}
+
+static void Animations_Draw(struct AnimationData* data, TextureLoc texLoc, int size) {
+	struct AnimationAtlas* atlas = &anims_atlases[Atlas1D_Index(texLoc)];
+	int row = Atlas1D_RowId(texLoc), srcX;
+	Bitmap frame;
+	if (!atlas->Bmp.Scan0) return;
+
+	/* Draw straight into the tile's location in the staging bitmap */
+	frame = atlas->Bmp;
+	frame.Scan0 = (uint8_t*)Bitmap_RawRow(&atlas->Bmp, (row - atlas->MinRow) * Atlas2D.TileSize);
 
 	if (!data) {
 #ifndef CC_BUILD_WEB
 		if (texLoc == LAVA_TEX_LOC) {
-			LavaAnimation_Tick((BitmapCol*)frame.Scan0, size);
+			LavaAnimation_Tick((BitmapCol*)frame.Scan0, size, frame.Width);
 		} else if (texLoc == WATER_TEX_LOC) {
-			WaterAnimation_Tick((BitmapCol*)frame.Scan0, size);
+			WaterAnimation_Tick((BitmapCol*)frame.Scan0, size, frame.Width);
 		}
 #endif
 	} else {
@@ -253,9 +356,9 @@ static void Animations_Draw(struct AnimationData* data, TextureLoc texLoc, int s
 		Bitmap_UNSAFE_CopyBlock(srcX, data->FrameY, 0, 0, &anims_bmp, &frame, size);
 	}
 
-	tex = Atlas1D.TexIds[dstX];
-	if (tex) { Gfx_UpdateTexturePart(tex, 0, dstY, &frame, Gfx.Mipmaps); }
-	if (size > ANIMS_FAST_SIZE) Mem_Free(ptr);
+	anims_dirty[texLoc] = true;
+	atlas->DirtyMin = min(atlas->DirtyMin, row);
+	atlas->DirtyMax = max(atlas->DirtyMax, row);
 }
 
 static void Animations_Apply(struct AnimationData* data) {
@@ -285,6 +388,7 @@ static bool Animations_IsDefaultZip(void) {
 }
 
 static void Animations_Clear(void) {
+	Animations_FreeStaging();
 	Mem_Free(anims_bmp.Scan0);
 	anims_count = 0;
 	anims_bmp.Scan0 = NULL;
@@ -297,6 +401,7 @@ static void Animations_Validate(void) {
 	int i, j;
 
 	anims_validated = true;
+	anims_staged    = false;
 	for (i = 0; i < anims_count; i++) {
 		data  = anims_list[i];
 
@@ -329,29 +434,31 @@ static void Animations_Validate(void) {
 static void Animations_Tick(struct ScheduledTask* task) {
 	int i, size;
 
+	if (anims_count && !anims_bmp.Scan0) {
+		Chat_AddRaw("&cCurrent texture pack specifies it uses animations,");
+		Chat_AddRaw("&cbut is missing animations.png");
+		anims_count = 0; anims_staged = false;
+	}
+
+	/* deferred, because when reading animations.txt, might not have read animations.png yet */
+	if (anims_count && !anims_validated) Animations_Validate();
+	if (!anims_staged) Animations_InitStaging();
+
 #ifndef CC_BUILD_WEB
 	if (useLavaAnim) {
-		size = min(Atlas2D.TileSize, 64);
+		size = min(Atlas2D.TileSize, LIQUID_ANIM_MAX);
 		Animations_Draw(NULL, LAVA_TEX_LOC, size);
 	}
 	if (useWaterAnim) {
-		size = min(Atlas2D.TileSize, 64);
+		size = min(Atlas2D.TileSize, LIQUID_ANIM_MAX);
 		Animations_Draw(NULL, WATER_TEX_LOC, size);
 	}
 #endif
 
-	if (!anims_count) return;
-	if (!anims_bmp.Scan0) {
-		Chat_AddRaw("&cCurrent texture pack specifies it uses animations,");
-		Chat_AddRaw("&cbut is missing animations.png");
-		anims_count = 0; return;
-	}
-
-	/* deferred, because when reading animations.txt, might not have read animations.png yet */
-	if (!anims_validated) Animations_Validate();
 	for (i = 0; i < anims_count; i++) {
 		Animations_Apply(&anims_list[i]);
 	}
+	Animations_Upload();
 }
 
 
@@ -383,19 +490,26 @@ static void Animations_FileChanged(void* obj, struct Stream* stream, const Strin
 	} else if (String_CaselessEqualsConst(name, "usewateranim")) {
 		useWaterAnim    = true;
 		alwaysWaterAnim = true;
+	} else {
+		return;
 	}
+	anims_staged = false;
 }
 
+static void Animations_AtlasChanged(void* obj) { anims_staged = false; }
+
 static void Animations_Init(void) {
 	ScheduledTask_Add(GAME_DEF_TICKS, Animations_Tick);
 	Event_RegisterVoid(&TextureEvents.PackChanged,  NULL, Animations_PackChanged);
 	Event_RegisterEntry(&TextureEvents.FileChanged, NULL, Animations_FileChanged);
+	Event_RegisterVoid(&TextureEvents.AtlasChanged, NULL, Animations_AtlasChanged);
 }
 
 static void Animations_Free(void) {
 	Animations_Clear();
 	Event_UnregisterVoid(&TextureEvents.PackChanged,  NULL, Animations_PackChanged);
 	Event_UnregisterEntry(&TextureEvents.FileChanged, NULL, Animations_FileChanged);
+	Event_UnregisterVoid(&TextureEvents.AtlasChanged, NULL, Animations_AtlasChanged);
 }
 
 struct IGameComponent Animations_Component = {
@@ -635,6 +749,7 @@ static ReturnCode TexturePack_ProcessZipEntry(const String* path, struct Stream*
 	return 0;
 }
 
+#define ZIP_BUFFER_SIZE (64 * 1024)
 /* Extracts all the files from a stream representing a .zip archive */
 static ReturnCode TexturePack_ExtractZip(struct Stream* stream) {
 	struct ZipState state;
@@ -646,21 +761,438 @@ static ReturnCode TexturePack_ExtractZip(struct Stream* stream) {
 	return Zip_Extract(&state);
 }
 
-/* Changes the current terrain atlas from a stream representing a .png image */
-/* Raises TextureEvents.PackChanged, so behaves as a .zip with only terrain.png in it */
-static ReturnCode TexturePack_ExtractPng(struct Stream* stream) {
-	Bitmap bmp; 
-	ReturnCode res = Png_Decode(&bmp, stream);
+/* Extracts all the files from a .zip archive stored in a file */
+/* Reads through a buffer, since otherwise each entry header results in several small file reads */
+static ReturnCode TexturePack_ExtractZipFile(struct Stream* file) {
+	struct Stream stream;
+	uint8_t* buffer;
+	ReturnCode res;
 
-	if (!res) {
-		Event_RaiseVoid(&TextureEvents.PackChanged);
-		if (Game_ChangeTerrainAtlas(&bmp)) return 0;
+	buffer = (uint8_t*)Mem_TryAlloc(ZIP_BUFFER_SIZE, 1);
+	if (!buffer) return TexturePack_ExtractZip(file);
+
+	Stream_ReadonlyBuffered(&stream, file, buffer, ZIP_BUFFER_SIZE);
+	res = TexturePack_ExtractZip(&stream);
+	Mem_Free(buffer);
+	return res;
+}
+
+/* Texture packs for maps are loaded on a background thread, which inflates every entry */
+/* and decodes every image. The main thread then only has to raise the events. */
+struct PackEntry { uint8_t* Data; uint32_t Size; Bitmap Bmp; String Name; char NameBuffer[FILENAME_SIZE]; };
+static struct PackEntry* pack_entries;
+static int pack_count, pack_capacity;
+
+static void* pack_thread;
+static volatile bool pack_done, pack_cancel;
+/* Whether a pack is being loaded, or has loaded but not been applied yet */
+/* NOTE: Can't just check pack_thread, as on web Thread_Start runs synchronously and returns NULL */
+static bool pack_pending;
+static bool pack_isZip;
+static struct Stream pack_source;
+static uint8_t* pack_sourceData;
+static ReturnCode pack_result;
+static String pack_url; static char pack_urlBuffer[STRING_SIZE];
+
+static void TexturePack_FreeEntries(void) {
+	int i;
+	for (i = 0; i < pack_count; i++) {
+		Mem_Free(pack_entries[i].Data);
+		Mem_Free(pack_entries[i].Bmp.Scan0);
+	}
+
+	Mem_Free(pack_entries);
+	pack_entries  = NULL;
+	pack_count    = 0;
+	pack_capacity = 0;
+}
+
+static ReturnCode TexturePack_AddEntry(const String* name, uint8_t* data, uint32_t size) {
+	struct PackEntry* e;
+	struct Stream mem;
+	ReturnCode res;
+
+	if (pack_count == pack_capacity) {
+		Utils_Resize((void**)&pack_entries, &pack_capacity, sizeof(struct PackEntry), 0, 32);
 	}
+	e = &pack_entries[pack_count++];
+	e->Data = data; e->Size = size;
+	e->Bmp.Scan0 = NULL;
+
+	String_InitArray(e->Name, e->NameBuffer);
+	String_AppendString(&e->Name, name);
 
-	Mem_Free(bmp.Scan0);
+	if (!Png_Detect(data, size)) return 0;
+	Stream_ReadonlyMemory(&mem, data, size);
+	if (!(res = Png_Decode(&e->Bmp, &mem))) return 0;
+
+	Mem_Free(e->Bmp.Scan0); 
+	e->Bmp.Scan0 = NULL;
 	return res;
 }
 
+/* Sizes of entries come from the pack, so are limited to avoid trying to allocate huge buffers */
+#define PACK_MAX_ENTRY_SIZE (64 * 1024 * 1024)
+
+static ReturnCode TexturePack_LoadZipEntry(const String* path, struct Stream* stream, struct ZipState* s) {
+	String name = *path;
+	uint32_t size = s->_curEntry->UncompressedSize;
+	uint8_t* data;
+	ReturnCode res;
+
+	/* NOTE: result is discarded anyways, so any error works here */
+	if (pack_cancel) return ERR_END_OF_STREAM;
+	Utils_UNSAFE_GetFilename(&name);
+
+	if (size > PACK_MAX_ENTRY_SIZE) return ERR_OUT_OF_MEMORY;
+	data = (uint8_t*)Mem_TryAlloc(size ? size : 1, 1);
+	if (!data) return ERR_OUT_OF_MEMORY;
+	if ((res = Stream_Read(stream, data, size))) { Mem_Free(data); return res; }
+
+	/* If decoding fails, leave it to event handler to decode again and report the error */
+	TexturePack_AddEntry(&name, data, size);
+	return 0;
+}
+
+/* Decoded texture packs are also cached in texturecache/, so loading the same pack again */
+/* can skip inflating and decoding. Images are stored as raw pixels, other files as is. */
+/* The decoded cache is only used when the raw cache's size, modified time, ETag and Last-Modified match. */
+/* Decoded packs are much larger than raw ones, so only the most recently used few are kept. */
+#define DECODED_MAGIC   0x44544343UL /* CCTD */
+#define DECODED_VERSION 1
+#define DECODED_HEADER_SIZE (26 + 2 * STRING_SIZE)
+#define DECODED_MAX_FILES 8
+#define DECODED_MAX_SIZE (128 * 1024 * 1024)
+static String pack_decodedPath; static char pack_decodedPathBuffer[FILENAME_SIZE];
+static String pack_etag;        static char pack_etagBuffer[STRING_SIZE];
+static String pack_lastMod;     static char pack_lastModBuffer[STRING_SIZE];
+static TimeMS pack_rawTime;
+
+/* Logger_Warn2 shows the warning in chat, so can't be used on the loader thread */
+static void TexturePack_LogError(ReturnCode res, const char* place, const String* path) {
+	Platform_Log3("Error %h when %c '%s'", &res, place, path);
+}
+
+static int TexturePack_MakeDecodedHeader(uint8_t* data, uint32_t rawSize, int decodeMs) {
+	int i = 26;
+	Stream_SetU32_LE(&data[0],  DECODED_MAGIC);
+	Stream_SetU32_LE(&data[4],  DECODED_VERSION);
+	Stream_SetU32_LE(&data[8],  rawSize);
+	Stream_SetU32_LE(&data[12], (uint32_t)(pack_rawTime >> 32));
+	Stream_SetU32_LE(&data[16], (uint32_t)pack_rawTime);
+	Stream_SetU32_LE(&data[20], decodeMs);
+
+	data[24] = pack_etag.length;    Mem_Copy(&data[i], pack_etag.buffer,    pack_etag.length);    i += pack_etag.length;
+	data[25] = pack_lastMod.length; Mem_Copy(&data[i], pack_lastMod.buffer, pack_lastMod.length); i += pack_lastMod.length;
+	return i;
+}
+
+static ReturnCode TexturePack_ReadDecodedEntry(struct Stream* s) {
+	String name; char nameBuffer[FILENAME_SIZE];
+	uint8_t header[13];
+	uint32_t width, height, size;
+	struct PackEntry* e;
+	ReturnCode res;
+
+	if ((res = Stream_Read(s, header, sizeof(header)))) return res;
+	width  = Stream_GetU32_LE(&header[0]);
+	height = Stream_GetU32_LE(&header[4]);
+	size   = Stream_GetU32_LE(&header[8]);
+
+	name = String_Init(nameBuffer, header[12], header[12]);
+	if ((res = Stream_Read(s, (uint8_t*)nameBuffer, name.length))) return res;
+
+	if (pack_count == pack_capacity) {
+		Utils_Resize((void**)&pack_entries, &pack_capacity, sizeof(struct PackEntry), 0, 32);
+	}
+	e = &pack_entries[pack_count++];
+	e->Data = NULL; e->Size = 0;
+	e->Bmp.Scan0 = NULL;
+	String_InitArray(e->Name, e->NameBuffer);
+	String_AppendString(&e->Name, &name);
+
+	/* Failing to allocate is treated as the cache being invalid, so the raw pack is decoded instead */
+	if (width) {
+		if ((uint64_t)width * height * 4 > PACK_MAX_ENTRY_SIZE) return ERR_INVALID_ARGUMENT;
+		e->Bmp.Scan0 = (uint8_t*)Mem_TryAlloc(width * height, 4);
+		if (!e->Bmp.Scan0) return ERR_OUT_OF_MEMORY;
+
+		e->Bmp.Width = width; e->Bmp.Height = height;
+		return Stream_Read(s, e->Bmp.Scan0, Bitmap_DataSize(width, height));
+	}
+
+	if (size > PACK_MAX_ENTRY_SIZE) return ERR_INVALID_ARGUMENT;
+	e->Data = (uint8_t*)Mem_TryAlloc(size ? size : 1, 1);
+	if (!e->Data) return ERR_OUT_OF_MEMORY;
+
+	e->Size = size;
+	return Stream_Read(s, e->Data, size);
+}
+
+/* Attempts to load all the entries from the decoded cache */
+static bool TexturePack_LoadDecoded(uint32_t rawSize, int* decodeMs) {
+	uint8_t expected[DECODED_HEADER_SIZE], header[DECODED_HEADER_SIZE + 4];
+	struct Stream file, s;
+	uint8_t* buffer;
+	uint32_t i, count;
+	int len;
+	ReturnCode res;
+
+	if (!pack_rawTime) return false;
+	if (Stream_OpenFile(&file, &pack_decodedPath)) return false;
+	buffer = (uint8_t*)Mem_Alloc(ZIP_BUFFER_SIZE, 1, "decoded cache buffer");
+	Stream_ReadonlyBuffered(&s, &file, buffer, ZIP_BUFFER_SIZE);
+
+	len = TexturePack_MakeDecodedHeader(expected, rawSize, 0);
+	res = Stream_Read(&s, header, len + 4);
+	*decodeMs = Stream_GetU32_LE(&header[20]);
+	Stream_SetU32_LE(&header[20], 0);
+
+	for (i = 0; !res && i < len; i++) {
+		if (header[i] != expected[i]) res = ERR_INVALID_ARGUMENT;
+	}
+	count = Stream_GetU32_LE(&header[len]);
+
+	for (i = 0; !res && i < count; i++) {
+		if (pack_cancel) res = ERR_END_OF_STREAM;
+		else res = TexturePack_ReadDecodedEntry(&s);
+	}
+
+	file.Close(&file);
+	Mem_Free(buffer);
+	/* Modified time of decoded file is only used to find the least recently used one */
+	if (!res) { File_SetModifiedTime(&pack_decodedPath, DateTime_CurrentUTC_MS()); return true; }
+
+	TexturePack_FreeEntries();
+	return false;
+}
+
+static ReturnCode TexturePack_WriteDecoded(struct Stream* s, uint32_t rawSize, int decodeMs) {
+	uint8_t header[DECODED_HEADER_SIZE + 4];
+	uint8_t entry[13];
+	struct PackEntry* e;
+	uint32_t size;
+	int i, len;
+	ReturnCode res;
+
+	len = TexturePack_MakeDecodedHeader(header, rawSize, decodeMs);
+	Stream_SetU32_LE(&header[len], pack_count);
+	if ((res = Stream_Write(s, header, len + 4))) return res;
+
+	for (i = 0; i < pack_count; i++) {
+		e = &pack_entries[i];
+		size = e->Bmp.Scan0 ? Bitmap_DataSize(e->Bmp.Width, e->Bmp.Height) : e->Size;
+
+		Stream_SetU32_LE(&entry[0], e->Bmp.Scan0 ? e->Bmp.Width  : 0);
+		Stream_SetU32_LE(&entry[4], e->Bmp.Scan0 ? e->Bmp.Height : 0);
+		Stream_SetU32_LE(&entry[8], size);
+		entry[12] = e->Name.length;
+
+		if ((res = Stream_Write(s, entry, sizeof(entry))))                        return res;
+		if ((res = Stream_Write(s, (uint8_t*)e->Name.buffer, e->Name.length)))    return res;
+		if ((res = Stream_Write(s, e->Bmp.Scan0 ? e->Bmp.Scan0 : e->Data, size))) return res;
+	}
+	return 0;
+}
+
+struct DecodedFiles { int Count; TimeMS OldestTime; String OldestPath; };
+static void TexturePack_FindDecodedCallback(const String* path, void* obj) {
+	static const String ext = String_FromConst(".dec");
+	struct DecodedFiles* files = (struct DecodedFiles*)obj;
+	TimeMS time;
+
+	if (!String_CaselessEnds(path, &ext)) return;
+	if (File_GetModifiedTime(path, &time)) return;
+	files->Count++;
+
+	if (files->OldestPath.length && time >= files->OldestTime) return;
+	files->OldestTime = time;
+	String_Copy(&files->OldestPath, path);
+}
+
+/* Deletes the least recently used decoded packs, until at most DECODED_MAX_FILES are left */
+static void TexturePack_EvictDecoded(void) {
+	static const String dir = String_FromConst("texturecache");
+	char pathBuffer[FILENAME_SIZE];
+	struct DecodedFiles files;
+	ReturnCode res;
+
+	for (;;) {
+		files.Count = 0;
+		String_InitArray(files.OldestPath, pathBuffer);
+
+		Directory_Enum(&dir, &files, TexturePack_FindDecodedCallback);
+		if (files.Count <= DECODED_MAX_FILES) return;
+
+		res = File_Delete(&files.OldestPath);
+		if (res) { TexturePack_LogError(res, "deleting", &files.OldestPath); return; }
+	}
+}
+
+static void TexturePack_SaveDecoded(uint32_t rawSize, int decodeMs) {
+	struct PackEntry* e;
+	struct Stream s;
+	uint64_t size = 0;
+	ReturnCode res;
+	int i;
+
+	if (!pack_rawTime) return;
+	for (i = 0; i < pack_count; i++) {
+		e = &pack_entries[i];
+		/* Name length is stored in a byte */
+		if (e->Name.length > 255) return;
+		size += e->Bmp.Scan0 ? Bitmap_DataSize(e->Bmp.Width, e->Bmp.Height) : e->Size;
+	}
+	if (size > DECODED_MAX_SIZE) return;
+
+	res = Stream_CreateFile(&s, &pack_decodedPath);
+	if (res) { TexturePack_LogError(res, "creating", &pack_decodedPath); return; }
+
+	res = TexturePack_WriteDecoded(&s, rawSize, decodeMs);
+	if (res) { TexturePack_LogError(res, "writing", &pack_decodedPath); }
+	/* Corrupt file is detected by failing to read it later, then just overwritten */
+	s.Close(&s);
+	TexturePack_EvictDecoded();
+}
+
+static void TexturePack_LoadPending(void) {
+	static const String terrain = String_FromConst("terrain.png");
+	struct ZipState state;
+	struct Stream stream;
+	uint8_t* buffer;
+	uint32_t size = 0;
+	int ms, decodeMs;
+	uint64_t beg = Stopwatch_Measure();
+	ReturnCode res;
+
+	pack_source.Length(&pack_source, &size);
+	if (TexturePack_LoadDecoded(size, &decodeMs)) {
+		pack_result = 0;
+		ms = (int)(Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure()) / 1000);
+		Platform_Log2("Loaded decoded texture pack in %i ms (decoding took %i ms)", &ms, &decodeMs);
+
+		pack_source.Close(&pack_source);
+		pack_done = true;
+		return;
+	}
+
+	if (pack_isZip) {
+		buffer = (uint8_t*)Mem_TryAlloc(ZIP_BUFFER_SIZE, 1);
+		stream = pack_source;
+		if (buffer) Stream_ReadonlyBuffered(&stream, &pack_source, buffer, ZIP_BUFFER_SIZE);
+
+		Zip_Init(&state, &stream);
+		state.ProcessEntry = TexturePack_LoadZipEntry;
+		pack_result = Zip_Extract(&state);
+		Mem_Free(buffer);
+	} else if (!(pack_result = pack_source.Length(&pack_source, &size))) {
+		/* Behaves as a .zip with only terrain.png in it */
+		buffer = (uint8_t*)Mem_Alloc(size ? size : 1, 1, "texture pack .png");
+		pack_result = Stream_Read(&pack_source, buffer, size);
+
+		if (pack_result) { Mem_Free(buffer); }
+		else { pack_result = TexturePack_AddEntry(&terrain, buffer, size); }
+	}
+
+	res = pack_source.Close(&pack_source);
+	if (res && !pack_result) pack_result = res;
+
+	if (!pack_result && !pack_cancel) {
+		ms = (int)(Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure()) / 1000);
+		Platform_Log1("Decoded texture pack in %i ms", &ms);
+		TexturePack_SaveDecoded(size, ms);
+	}
+	pack_done = true;
+}
+
+static void TexturePack_FreePending(void) {
+	TexturePack_FreeEntries();
+	Mem_Free(pack_sourceData);
+	pack_sourceData = NULL;
+}
+
+/* Stops loading the pending texture pack, if there is one */
+static void TexturePack_CancelPending(void) {
+	if (!pack_pending) return;
+	pack_cancel = true;
+
+	Thread_Join(pack_thread);
+	pack_thread  = NULL;
+	pack_pending = false;
+	TexturePack_FreePending();
+}
+
+/* Starts loading the given texture pack on a background thread */
+static void TexturePack_StartPending(const String* url, struct Stream* source, bool zip) {
+	String etag    = TextureCache_GetETag(url);
+	String lastMod = TextureCache_GetLastModified(url);
+
+	TexturePack_CancelPending();
+	String_InitArray(pack_url, pack_urlBuffer);
+	String_AppendString(&pack_url, url);
+
+	String_InitArray(pack_etag,    pack_etagBuffer);
+	String_AppendString(&pack_etag,    &etag);
+	String_InitArray(pack_lastMod, pack_lastModBuffer);
+	String_AppendString(&pack_lastMod, &lastMod);
+
+	/* Decoded cache is invalid if the raw cached file has changed since */
+	String_InitArray(pack_decodedPath, pack_decodedPathBuffer);
+	TextureCache_MakePath(&pack_decodedPath, url);
+	if (File_GetModifiedTime(&pack_decodedPath, &pack_rawTime)) pack_rawTime = 0;
+	String_AppendConst(&pack_decodedPath, ".dec");
+
+	pack_source = *source;
+	pack_isZip  = zip;
+	pack_done   = false;
+	pack_cancel = false;
+
+	pack_pending = true;
+	pack_thread  = Thread_Start(TexturePack_LoadPending, false);
+}
+
+static void TexturePack_ApplyPending(void) {
+	struct PackEntry* e;
+	struct Stream stream;
+	int i;
+
+	Thread_Join(pack_thread);
+	pack_thread  = NULL;
+	pack_pending = false;
+
+	/* Took too long to load and is no longer active texture pack */
+	if (!String_Equals(&World_TextureUrl, &pack_url)) {
+		TexturePack_FreePending(); return;
+	}
+
+	if (pack_isZip || !pack_result) {
+		Event_RaiseVoid(&TextureEvents.PackChanged);
+
+		/* Textures can't be created without a context, so only the PackChanged event is raised */
+		for (i = 0; i < pack_count && !Gfx.LostContext; i++) {
+			e = &pack_entries[i];
+			Png_MakeDecodedStream(&stream, e->Data, e->Size, &e->Bmp);
+			Event_RaiseEntry(&TextureEvents.FileChanged, &stream, &e->Name);
+		}
+	}
+
+	if (pack_result) Logger_Warn2(pack_result, pack_isZip ? "extracting" : "decoding", &pack_url);
+	TexturePack_FreePending();
+}
+
+static void TexturePack_Tick(struct ScheduledTask* task) {
+	if (pack_pending && pack_done) TexturePack_ApplyPending();
+}
+
+static void TexturePack_Init(void) {
+	ScheduledTask_Add(GAME_DEF_TICKS, TexturePack_Tick);
+}
+
+struct IGameComponent TexturePack_Component = {
+	TexturePack_Init,         /* Init  */
+	TexturePack_CancelPending /* Free  */
+};
+
 void TexturePack_ExtractZip_File(const String* filename) {
 	String path; char pathBuffer[FILENAME_SIZE];
 	struct Stream stream;
@@ -675,13 +1207,14 @@ void TexturePack_ExtractZip_File(const String* filename) {
 	Directory_SetCurrent(&memPath);
 #endif
 
+	TexturePack_CancelPending();
 	String_InitArray(path, pathBuffer);
 	String_Format1(&path, "texpacks/%s", filename);
 
 	res = Stream_OpenFile(&stream, &path);
 	if (res) { Logger_Warn2(res, "opening", &path); return; }
 
-	res = TexturePack_ExtractZip(&stream);
+	res = TexturePack_ExtractZipFile(&stream);
 	if (res) { Logger_Warn2(res, "extracting", &path); }
 
 	res = stream.Close(&stream);
@@ -699,7 +1232,6 @@ void TexturePack_ExtractCurrent(bool forceReload) {
 	String url = World_TextureUrl, file;
 	struct Stream stream;
 	bool zip;
-	ReturnCode res;
 
 	if (!url.length || !TextureCache_Get(&url, &stream)) {
 		/* don't pointlessly load default texture pack */
@@ -710,11 +1242,7 @@ void TexturePack_ExtractCurrent(bool forceReload) {
 		texturePackDefault = true;
 	} else {
 		zip = String_ContainsString(&url, &zipExt);
-		res = zip ? TexturePack_ExtractZip(&stream) : TexturePack_ExtractPng(&stream);
-		if (res) Logger_Warn2(res, zip ? "extracting" : "decoding", &url);
-
-		res = stream.Close(&stream);
-		if (res) Logger_Warn2(res, "closing cache for", &url);
+		TexturePack_StartPending(&url, &stream, zip);
 		texturePackDefault = false;
 	}
 }
@@ -723,8 +1251,6 @@ void TexturePack_Extract_Req(struct HttpRequest* item) {
 	String url;
 	uint8_t* data; uint32_t len;
 	struct Stream mem;
-	bool png;
-	ReturnCode res;
 
 	url = String_FromRawArray(item->URL);
 	/* Took too long to download and is no longer active texture pack */
@@ -733,15 +1259,16 @@ void TexturePack_Extract_Req(struct HttpRequest* item) {
 	data = item->Data;
 	len  = item->Size;
 	Stream_ReadonlyMemory(&mem, data, len);
+	TexturePack_StartPending(&url, &mem, !Png_Detect(data, len));
 
-	png = Png_Detect(data, len);
-	res = png ? TexturePack_ExtractPng(&mem) : TexturePack_ExtractZip(&mem);
-
-	if (res) Logger_Warn2(res, png ? "decoding" : "extracting", &url);
+	/* Data is freed once the texture pack has finished loading */
+	pack_sourceData = data;
+	item->Data      = NULL;
+	item->Size      = 0;
 	texturePackDefault = false;
 }
 
-void TexturePack_DownloadAsync(const String* url, const String* id) {
+void TextureCache_DownloadAsync(const String* url, bool priority, const String* id) {
 	String etag = String_Empty;
 	String time = String_Empty;
 
@@ -751,5 +1278,9 @@ void TexturePack_DownloadAsync(const String* url, const String* id) {
 		time = TextureCache_GetLastModified(url);
 		etag = TextureCache_GetETag(url);
 	}
-	Http_AsyncGetDataEx(url, true, id, &time, &etag, NULL);
+	Http_AsyncGetDataEx(url, priority, id, &time, &etag, NULL);
+}
+
+void TexturePack_DownloadAsync(const String* url, const String* id) {
+	TextureCache_DownloadAsync(url, true, id);
 }
@@ -13,6 +13,7 @@ struct Stream;
 struct HttpRequest;
 struct IGameComponent;
 extern struct IGameComponent Animations_Component;
+extern struct IGameComponent TexturePack_Component;
 
 /* Number of tiles in each row */
 #define ATLAS2D_TILES_PER_ROW 16
@@ -89,6 +90,9 @@ bool TextureCache_Has(const String* url);
 bool TextureCache_Get(const String* url, struct Stream* stream);
 /* Updates cached data, ETag, and Last-Modified for the given URL. */
 void TextureCache_Update(struct HttpRequest* req);
+/* Asynchronously downloads the given URL. */
+/* If the URL is cached, the request is conditional on cached ETag/Last-Modified. (304 if unchanged) */
+void TextureCache_DownloadAsync(const String* url, bool priority, const String* id);
 
 /* Extracts a texture pack .zip from the given file. */
 void TexturePack_ExtractZip_File(const String* filename);
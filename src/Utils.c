@@ -6,6 +6,7 @@
 #include "Stream.h"
 #include "Errors.h"
 #include "Logger.h"
+#include "Funcs.h"
 
 
 /*########################################################################################################################*
@@ -281,44 +282,87 @@ void EntryList_Save(struct EntryList* list) {
 	if (res) { Logger_Warn2(res, "closing", &path); }
 }
 
-int EntryList_Remove(struct EntryList* list, const String* key) {
-	int i = EntryList_Find(list, key);
-	if (i >= 0) StringsBuffer_Remove(&list->entries, i);
-	return i;
+/* Entries are also indexed by a caseless hash of their key, so lookups don't need to search every entry */
+#define ENTRYLIST_MIN_BUCKETS 64
+
+/* FNV-1a hash of the lowercased key */
+static uint32_t EntryList_Hash(const String* key) {
+	uint32_t hash = 2166136261U;
+	char c;
+	int i;
+
+	for (i = 0; i < key->length; i++) {
+		c = key->buffer[i]; Char_MakeLower(c);
+		hash = (hash ^ (uint8_t)c) * 16777619U;
+	}
+	return hash;
 }
 
-void EntryList_Set(struct EntryList* list, const String* key, const String* value) {
-	String entry; char entryBuffer[1024];
-	String_InitArray(entry, entryBuffer);
+static void EntryList_Link(struct EntryList* list, int i) {
+	int bucket = list->hashes[i].Hash & (list->bucketsCount - 1);
+	list->hashes[i].Next  = list->buckets[bucket];
+	list->buckets[bucket] = i;
+}
 
-	if (value->length) {
-		String_Format3(&entry, "%s%r%s", key, &list->separator, value);
-	} else {
-		String_Copy(&entry, key);
+/* Doubles the number of buckets, then relinks all entries */
+static void EntryList_Rehash(struct EntryList* list) {
+	int i;
+	list->bucketsCount = max(ENTRYLIST_MIN_BUCKETS, list->bucketsCount * 2);
+	Mem_Free(list->buckets);
+	list->buckets = (int*)Mem_Alloc(list->bucketsCount, sizeof(int), "entry buckets");
+
+	for (i = 0; i < list->bucketsCount; i++) { list->buckets[i] = -1; }
+	for (i = 0; i < list->entries.count; i++) { EntryList_Link(list, i); }
+}
+
+static void EntryList_Add(struct EntryList* list, const String* entry) {
+	String key, value;
+	int i = list->entries.count;
+	StringsBuffer_Add(&list->entries, entry);
+
+	if (i == list->hashesCapacity) {
+		Utils_Resize((void**)&list->hashes, &list->hashesCapacity,
+					sizeof(struct EntryHash), 0, max(ENTRYLIST_MIN_BUCKETS, i));
 	}
+	String_UNSAFE_Separate(entry, list->separator, &key, &value);
+	list->hashes[i].Hash = EntryList_Hash(&key);
 
-	EntryList_Remove(list, key);
-	StringsBuffer_Add(&list->entries, &entry);
+	if (list->entries.count > list->bucketsCount) {
+		EntryList_Rehash(list);
+	} else {
+		EntryList_Link(list, i);
+	}
 }
 
-String EntryList_UNSAFE_Get(struct EntryList* list, const String* key) {
-	String curEntry, curKey, curValue;
+static void EntryList_RemoveAt(struct EntryList* list, int index) {
+	struct EntryHash* hashes = list->hashes;
+	int* link = &list->buckets[hashes[index].Hash & (list->bucketsCount - 1)];
 	int i;
 
-	for (i = 0; i < list->entries.count; i++) {
-		curEntry = StringsBuffer_UNSAFE_Get(&list->entries, i);
-		String_UNSAFE_Separate(&curEntry, list->separator, &curKey, &curValue);
+	while (*link != index) { link = &hashes[*link].Next; }
+	*link = hashes[index].Next;
+	StringsBuffer_Remove(&list->entries, index);
 
-		if (String_CaselessEquals(key, &curKey)) return curValue;
+	/* Later entries have all moved down one index */
+	for (i = index; i < list->entries.count; i++) { hashes[i] = hashes[i + 1]; }
+	for (i = 0; i < list->entries.count; i++) {
+		if (hashes[i].Next > index) hashes[i].Next--;
+	}
+	for (i = 0; i < list->bucketsCount; i++) {
+		if (list->buckets[i] > index) list->buckets[i]--;
 	}
-	return String_Empty;
 }
 
 int EntryList_Find(struct EntryList* list, const String* key) {
 	String curEntry, curKey, curValue;
+	uint32_t hash;
 	int i;
 
-	for (i = 0; i < list->entries.count; i++) {
+	if (!list->bucketsCount) return -1;
+	hash = EntryList_Hash(key);
+
+	for (i = list->buckets[hash & (list->bucketsCount - 1)]; i >= 0; i = list->hashes[i].Next) {
+		if (list->hashes[i].Hash != hash) continue;
 		curEntry = StringsBuffer_UNSAFE_Get(&list->entries, i);
 		String_UNSAFE_Separate(&curEntry, list->separator, &curKey, &curValue);
 
@@ -327,8 +371,148 @@ int EntryList_Find(struct EntryList* list, const String* key) {
 	return -1;
 }
 
+int EntryList_Remove(struct EntryList* list, const String* key) {
+	int i = EntryList_Find(list, key);
+	if (i >= 0) EntryList_RemoveAt(list, i);
+	return i;
+}
+
+void EntryList_Set(struct EntryList* list, const String* key, const String* value) {
+	String entry; char entryBuffer[1024];
+	String cur;
+	int i;
+	String_InitArray(entry, entryBuffer);
+
+	if (value->length) {
+		String_Format3(&entry, "%s%r%s", key, &list->separator, value);
+	} else {
+		String_Copy(&entry, key);
+	}
+
+	i = EntryList_Find(list, key);
+	if (i >= 0) {
+		/* Avoid removing and re-adding the entry when it hasn't changed */
+		cur = StringsBuffer_UNSAFE_Get(&list->entries, i);
+		if (String_Equals(&cur, &entry)) return;
+		EntryList_RemoveAt(list, i);
+	}
+	EntryList_Add(list, &entry);
+}
+
+String EntryList_UNSAFE_Get(struct EntryList* list, const String* key) {
+	String curEntry, curKey, curValue;
+	int i = EntryList_Find(list, key);
+	if (i == -1) return String_Empty;
+
+	curEntry = StringsBuffer_UNSAFE_Get(&list->entries, i);
+	String_UNSAFE_Separate(&curEntry, list->separator, &curKey, &curValue);
+	return curValue;
+}
+
+void EntryList_Clear(struct EntryList* list) {
+	StringsBuffer_Clear(&list->entries);
+	Mem_Free(list->hashes);
+	Mem_Free(list->buckets);
+
+	list->hashes  = NULL; list->hashesCapacity = 0;
+	list->buckets = NULL; list->bucketsCount   = 0;
+}
+
 void EntryList_Init(struct EntryList* list, const char* path, char separator) {
 	list->path      = path;
 	list->separator = separator;
 	EntryList_Load(list, NULL);
 }
+
+
+/*########################################################################################################################*
+*-----------------------------------------------------------Arena---------------------------------------------------------*
+*#########################################################################################################################*/
+/* Committing in large steps avoids making a system call for every allocation */
+#define ARENA_COMMIT_SIZE (1024 * 1024)
+#define Arena_RoundCommit(size) (((size) + (ARENA_COMMIT_SIZE - 1)) & ~(ARENA_COMMIT_SIZE - 1))
+/* NOTE: Header is 2 pointers in size, so memory after it keeps the heap's alignment */
+struct ArenaBlock { struct ArenaBlock* next; uintptr_t size; };
+
+static bool Arena_Commit(struct Arena* a, uint32_t end) {
+	uint32_t commitEnd;
+	if (end <= a->committed) return true;
+
+	commitEnd = min(a->capacity, Arena_RoundCommit(end));
+	if (!Mem_Commit(a->base + a->committed, commitEnd - a->committed)) return false;
+	a->committed = commitEnd;
+	return true;
+}
+
+static void* Arena_AllocCore(struct Arena* a, uint32_t size, bool cleared, const char* place) {
+	struct ArenaBlock* block;
+	uint32_t beg, end;
+	uint8_t* ptr;
+
+	if (!a->base && a->capacity) {
+		a->base = (uint8_t*)Mem_Reserve(a->capacity);
+		if (!a->base) a->capacity = 0;
+	}
+	beg = (a->used + 15) & ~15;
+	end = beg + size;
+
+	if (a->base && end >= beg && end <= a->capacity && Arena_Commit(a, end)) {
+		ptr = a->base + beg;
+		/* Freshly committed memory is always 0, so only need to clear reused memory */
+		if (cleared && beg < a->dirty) Mem_Set(ptr, 0, min(end, a->dirty) - beg);
+
+		a->dirty = max(a->dirty, end);
+		a->used  = end;
+	} else {
+		block = (struct ArenaBlock*)(cleared ? Mem_AllocCleared(1, sizeof(struct ArenaBlock) + size, place)
+											 : Mem_Alloc(1,        sizeof(struct ArenaBlock) + size, place));
+		block->next = a->blocks;
+		block->size = size;
+
+		a->blocks      = block;
+		a->blocksSize += size;
+		ptr = (uint8_t*)(block + 1);
+	}
+
+	a->highWater = max(a->highWater, a->used + a->blocksSize);
+	return ptr;
+}
+
+void* Arena_Alloc(struct Arena* a, uint32_t numElems, uint32_t elemsSize, const char* place) {
+	return Arena_AllocCore(a, numElems * elemsSize, false, place); /* TODO: avoid overflow here */
+}
+
+void* Arena_AllocCleared(struct Arena* a, uint32_t numElems, uint32_t elemsSize, const char* place) {
+	return Arena_AllocCore(a, numElems * elemsSize, true, place); /* TODO: avoid overflow here */
+}
+
+void Arena_Reset(struct Arena* a) {
+	struct ArenaBlock* block;
+	struct ArenaBlock* next;
+	uint32_t keep;
+
+	for (block = a->blocks; block; block = next) {
+		next = block->next;
+		Mem_Free(block);
+	}
+	a->blocks     = NULL;
+	a->blocksSize = 0;
+
+	/* Keep as much memory committed as was just used, since the next map is often similarly sized */
+	keep = Arena_RoundCommit(a->used);
+	if (keep < a->committed) {
+		Mem_Decommit(a->base + keep, a->committed - keep);
+		a->committed = keep;
+		a->dirty     = min(a->dirty, keep);
+	}
+	a->used = 0;
+}
+
+void Arena_Free(struct Arena* a) {
+	Arena_Reset(a);
+	if (a->base) Mem_Release(a->base, a->capacity);
+
+	a->base      = NULL;
+	a->committed = 0;
+	a->dirty     = 0;
+}
@@ -55,10 +55,17 @@ int Convert_ToBase64(const uint8_t* src, int len, char* dst);
 /* NOTE: You MUST ensure that dst is appropriately sized. */
 int Convert_FromBase64(const char* src, int len, uint8_t* dst);
 
+struct EntryHash { uint32_t Hash; int Next; };
 struct EntryList {
 	const char* path;
 	char separator;
 	StringsBuffer entries;
+	/* Hash of each entry's key, and index of next entry in the same bucket */
+	struct EntryHash* hashes;
+	int hashesCapacity;
+	/* Index of first entry in each bucket, or -1 if bucket is empty */
+	int* buckets;
+	int bucketsCount;
 };
 typedef bool (*EntryList_Filter)(const String* entry);
 
@@ -74,6 +81,38 @@ CC_NOINLINE void EntryList_Set(struct EntryList* list, const String* key, const
 CC_NOINLINE STRING_REF String EntryList_UNSAFE_Get(struct EntryList* list, const String* key);
 /* Finds the index of the entry whose key caselessly equals the given key. */
 CC_NOINLINE int EntryList_Find(struct EntryList* list, const String* key);
+/* Removes all entries, and frees the memory used by the EntryList. */
+CC_NOINLINE void EntryList_Clear(struct EntryList* list);
+/* NOTE: Entries must only be added or removed using the EntryList functions, */
+/* otherwise the hash index of entries will be out of sync with the entries. */
 /* Initialises the EntryList and loads the entries from disc. */
 void EntryList_Init(struct EntryList* list, const char* path, char separator);
+
+struct ArenaBlock;
+/* Bump allocator for memory which is all freed at once. (e.g. data sized to the current map) */
+/* Memory comes from one range of reserved address space, which is committed as needed. */
+/* Allocations which don't fit in there (or if reserving is unsupported) use separate heap blocks. */
+/* NOTE: Not thread safe. */
+struct Arena {
+	uint32_t capacity;  /* Size of address space to reserve, 0 if reserving failed */
+	uint8_t* base;      /* Start of reserved address space, NULL if not reserved yet */
+	uint32_t committed; /* Bytes at start of reserved address space backed by memory */
+	uint32_t used;      /* Bytes at start of reserved address space allocated */
+	uint32_t dirty;     /* Bytes at start of reserved address space which may not be all 0 */
+	struct ArenaBlock* blocks; /* Heap blocks for allocations which didn't fit */
+	uint32_t blocksSize;       /* Total size of allocations in heap blocks */
+	uint32_t highWater;        /* Most bytes that have been allocated at once */
+};
+
+/* Allocates a block of memory from the arena, with undetermined contents. */
+/* NOTE: Exits process on allocation failure, like Mem_Alloc. */
+CC_NOINLINE void* Arena_Alloc(struct Arena* arena, uint32_t numElems, uint32_t elemsSize, const char* place);
+/* Allocates a block of memory from the arena, with contents of all 0. */
+/* NOTE: Exits process on allocation failure, like Mem_AllocCleared. */
+CC_NOINLINE void* Arena_AllocCleared(struct Arena* arena, uint32_t numElems, uint32_t elemsSize, const char* place);
+/* Frees all memory allocated from the arena. */
+/* NOTE: Memory committed beyond what was used is given back to the OS. */
+CC_NOINLINE void Arena_Reset(struct Arena* arena);
+/* Frees all memory allocated from the arena, and releases its reserved address space. */
+CC_NOINLINE void Arena_Free(struct Arena* arena);
 #endif
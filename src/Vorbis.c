@@ -992,8 +992,9 @@ void imdct_calc(float* in, float* out, struct imdct_state* state) {
 	/* Uses a few fixes for the paper noted at http://www.nothings.org/stb_vorbis/mdct_01.txt */
 	float *A = state->a, *B = state->b, *C = state->c;
 
-	float u[VORBIS_MAX_BLOCK_SIZE];
-	float w[VORBIS_MAX_BLOCK_SIZE];
+	float bufferU[VORBIS_MAX_BLOCK_SIZE];
+	float bufferW[VORBIS_MAX_BLOCK_SIZE];
+	float *u = bufferU, *w = bufferW, *tmp;
 	float e_1, e_2, f_1, f_2;
 	float g_1, g_2, h_1, h_2;
 	float x_1, x_2, y_1, y_2;
@@ -1034,10 +1035,9 @@ void imdct_calc(float* in, float* out, struct imdct_state* state) {
 			}
 		}
 
-		/* TODO: eliminate this, do w/u in-place */
-		/* TODO: dynamically allocate mem for imdct */
+		/* every odd element of u is written each pass, so just swap buffers instead of copying */
 		if (l+1 <= log2_n - 4) {
-			Mem_Copy(w, u, sizeof(u));
+			tmp = w; w = u; u = tmp;
 		}
 	}
 
@@ -1413,6 +1413,33 @@ ReturnCode Vorbis_DecodeFrame(struct VorbisState* ctx) {
 	return 0;
 }
 
+/* Converts samples to 16 bit PCM, writing to every stride'th element of dst */
+static void Vorbis_ToPCM(const float* src, int16_t* dst, int count, int stride) {
+	float sample;
+	int i;
+
+	for (i = 0; i < count; i++, dst += stride) {
+		sample = src[i];
+		Math_Clamp(sample, -1.0f, 1.0f);
+		*dst = (int16_t)(sample * 32767);
+	}
+}
+
+/* Windows, overlaps and adds samples, then converts to 16 bit PCM like Vorbis_ToPCM */
+static void Vorbis_OverlapToPCM(const float* prev, const float* cur, struct VorbisWindow* window, 
+								int16_t* dst, int count, int stride) {
+	const float* prevWindow = window->Prev;
+	const float* curWindow  = window->Cur;
+	float sample;
+	int i;
+
+	for (i = 0; i < count; i++, dst += stride) {
+		sample = prev[i] * prevWindow[i] + cur[i] * curWindow[i];
+		Math_Clamp(sample, -1.0f, 1.0f);
+		*dst = (int16_t)(sample * 32767);
+	}
+}
+
 int Vorbis_OutputFrame(struct VorbisState* ctx, int16_t* data) {
 	struct VorbisWindow window;
 	float* prev[VORBIS_MAX_CHANS];
@@ -1420,8 +1447,7 @@ int Vorbis_OutputFrame(struct VorbisState* ctx, int16_t* data) {
 
 	int curQrtr, prevQrtr, overlapQtr;
 	int curOffset, prevOffset, overlapSize;
-	float sample;
-	int i, ch;
+	int i, ch, channels = ctx->channels;
 
 	/* first frame decoded has no data */
 	if (ctx->prevBlockSize == 0) {
@@ -1453,13 +1479,11 @@ int Vorbis_OutputFrame(struct VorbisState* ctx, int16_t* data) {
 	}
 
 	/* for long prev and short cur block, there will be non-overlapped data before */
-	for (i = 0; i < prevOffset; i++) {
-		for (ch = 0; ch < ctx->channels; ch++) {
-			sample = prev[ch][i];
-			Math_Clamp(sample, -1.0f, 1.0f);
-			*data++ = (int16_t)(sample * 32767);
-		}
+	/* NOTE: channels are processed one at a time, as tight loops over each channel are much faster */
+	for (ch = 0; ch < channels; ch++) {
+		Vorbis_ToPCM(prev[ch], data + ch, prevOffset, channels);
 	}
+	data += prevOffset * channels;
 
 	/* adjust pointers to start at 0 for overlapping */
 	for (i = 0; i < ctx->channels; i++) {
@@ -1471,22 +1495,15 @@ int Vorbis_OutputFrame(struct VorbisState* ctx, int16_t* data) {
 
 	/* overlap and add data */
 	/* also perform windowing here */
-	for (i = 0; i < overlapSize; i++) {
-		for (ch = 0; ch < ctx->channels; ch++) {
-			sample = prev[ch][i] * window.Prev[i] + cur[ch][i] * window.Cur[i];
-			Math_Clamp(sample, -1.0f, 1.0f);
-			*data++ = (int16_t)(sample * 32767);
-		}
+	for (ch = 0; ch < channels; ch++) {
+		Vorbis_OverlapToPCM(prev[ch], cur[ch], &window, data + ch, overlapSize, channels);
 	}
+	data += overlapSize * channels;
 
 	/* for long cur and short prev block, there will be non-overlapped data after */
-	for (i = 0; i < ctx->channels; i++) { cur[i] += overlapSize; }
-	for (i = 0; i < curOffset; i++) {
-		for (ch = 0; ch < ctx->channels; ch++) {
-			sample = cur[ch][i];
-			Math_Clamp(sample, -1.0f, 1.0f);
-			*data++ = (int16_t)(sample * 32767);
-		}
+	for (i = 0; i < channels; i++) { cur[i] += overlapSize; }
+	for (ch = 0; ch < channels; ch++) {
+		Vorbis_ToPCM(cur[ch], data + ch, curOffset, channels);
 	}
 
 	ctx->prevBlockSize = ctx->curBlockSize;
@@ -2200,7 +2200,7 @@ static void TextGroupWidget_UpdateY(struct TextGroupWidget* w) {
 
 void TextGroupWidget_SetUsePlaceHolder(struct TextGroupWidget* w, int index, bool placeHolder) {
 	w->placeholderHeight[index] = placeHolder;
-	if (w->textures[index].ID) return;
+	if (w->textures[index].Width) return;
 
 	w->textures[index].Height = placeHolder ? w->defaultHeight : 0;
 	TextGroupWidget_UpdateY(w);
@@ -2211,7 +2211,7 @@ int TextGroupWidget_UsedHeight(struct TextGroupWidget* w) {
 	int i, height = 0;
 
 	for (i = 0; i < w->lines; i++) {
-		if (textures[i].ID) break;
+		if (textures[i].Width) break;
 	}
 	for (; i < w->lines; i++) {
 		height += textures[i].Height;
@@ -2419,7 +2419,7 @@ void TextGroupWidget_GetSelected(struct TextGroupWidget* w, String* text, int x,
 	int i;
 
 	for (i = 0; i < w->lines; i++) {
-		if (!w->textures[i].ID) continue;
+		if (!w->textures[i].Width) continue;
 		tex = w->textures[i];
 		if (!Gui_Contains(tex.X, tex.Y, tex.Width, tex.Height, x, y)) continue;
 
@@ -2490,6 +2490,8 @@ void TextGroupWidget_Redraw(struct TextGroupWidget* w, int index) {
 	String text;
 	struct DrawTextArgs args;
 	struct Texture tex = { 0 };
+	Size2D size;
+	int height;
 	Gfx_DeleteTexture(&w->textures[index].ID);
 
 	text = TextGroupWidget_UNSAFE_Get(w, index);
@@ -2498,10 +2500,16 @@ void TextGroupWidget_Redraw(struct TextGroupWidget* w, int index) {
 
 		if (w->underlineUrls && TextGroupWidget_MightHaveUrls(w)) {
 			TextGroupWidget_DrawAdvanced(w, &tex, &args, index, &text);
+			Drawer2D_ReducePadding_Tex(&tex, w->font.Size, 3);
 		} else {
-			Drawer2D_MakeTextTexture(&tex, &args, 0, 0);
+			/* Plain lines are drawn from the glyph atlas, so only their size is needed */
+			size   = Drawer2D_MeasureText(&args);
+			height = size.Height;
+			Drawer2D_ReducePadding_Height(&height, w->font.Size, 3);
+
+			tex.Width  = size.Width;
+			tex.Height = height;
 		}
-		Drawer2D_ReducePadding_Tex(&tex, w->font.Size, 3);
 	} else {
 		tex.Height = w->placeholderHeight[index] ? w->defaultHeight : 0;
 	}
@@ -2528,15 +2536,30 @@ static void TextGroupWidget_Init(void* widget) {
 	TextGroupWidget_UpdateDimensions(w);
 }
 
+void TextGroupWidget_RenderLine(struct TextGroupWidget* w, int index, int y) {
+	struct Texture tex = w->textures[index];
+	struct DrawTextArgs args;
+	String text;
+	int height;
+
+	if (!tex.Width) return;
+	if (tex.ID) { tex.Y = y; Texture_Render(&tex); return; }
+
+	text = TextGroupWidget_UNSAFE_Get(w, index);
+	DrawTextArgs_Make(&args, &text, &w->font, true);
+	/* Line height may have been reduced by Drawer2D_ReducePadding_Height */
+	height = Drawer2D_FontHeight(&w->font, true);
+	Drawer2D_DrawGlyphText(&args, tex.X, y - (height - tex.Height) / 2);
+}
+
 static void TextGroupWidget_Render(void* widget, double delta) {
 	struct TextGroupWidget* w = (struct TextGroupWidget*)widget;
-	struct Texture* textures  = w->textures;
 	int i;
 
 	for (i = 0; i < w->lines; i++) {
-		if (!textures[i].ID) continue;
-		Texture_Render(&textures[i]);
+		TextGroupWidget_RenderLine(w, i, w->textures[i].Y);
 	}
+	Drawer2D_FlushGlyphs();
 }
 
 static void TextGroupWidget_Free(void* widget) {
@@ -189,6 +189,8 @@ typedef String (*TextGroupWidget_Get)(void* obj, int i);
 #define TEXTGROUPWIDGET_LEN (STRING_SIZE + (STRING_SIZE / 2))
 
 /* A group of text labels. */
+/* NOTE: Plain text lines are drawn from the shared glyph atlas, in which case the */
+/* line's texture only has its position and size set, and its ID is GFX_NULL. */
 struct TextGroupWidget {
 	Widget_Layout
 	int lines, defaultHeight;
@@ -218,6 +220,9 @@ CC_NOINLINE void TextGroupWidget_GetSelected(struct TextGroupWidget* w, String*
 CC_NOINLINE void TextGroupWidget_Redraw(struct TextGroupWidget* w, int index);
 /* Calls TextGroupWidget_Redraw for all lines */
 CC_NOINLINE void TextGroupWidget_RedrawAll(struct TextGroupWidget* w);
+/* Draws the given line, with its top at the given Y coordinate. */
+/* NOTE: Text may be queued in the glyph atlas, so call Drawer2D_FlushGlyphs afterwards. */
+CC_NOINLINE void TextGroupWidget_RenderLine(struct TextGroupWidget* w, int index, int y);
 /* Gets the text for the i'th line. */
 static String TextGroupWidget_UNSAFE_Get(struct TextGroupWidget* w, int i) { return w->GetLine(w->getLineObj, i); }
 
@@ -9,8 +9,12 @@
 #include "Physics.h"
 #include "Game.h"
 #include "TexturePack.h"
+#include "Utils.h"
 
 struct _WorldData World;
+/* Address space is plentiful with 64 bit, so reserve enough for even the largest maps */
+#define WORLD_ARENA_SIZE (sizeof(void*) == 8 ? 2048u * 1024 * 1024 : 256u * 1024 * 1024)
+struct Arena World_MapArena = { WORLD_ARENA_SIZE };
 /*########################################################################################################################*
 *----------------------------------------------------------World----------------------------------------------------------*
 *#########################################################################################################################*/
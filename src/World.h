@@ -41,6 +41,9 @@ CC_VAR extern struct _WorldData {
 #endif
 } World;
 extern String World_TextureUrl;
+/* Memory for data sized to the current map, which is all freed once a new map starts loading. */
+/* (e.g. lighting heightmap, chunk info) Freed after all components have handled WorldEvents.NewMap */
+extern struct Arena World_MapArena;
 
 /* Frees the blocks array, sets dimensions to 0, resets environment to default. */
 CC_API void World_Reset(void);